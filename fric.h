@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : FRIC.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef FRIC_H_
+#define FRIC_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+#include "position.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define FRIC_RATE       0.05f   // Calibration duty ramp rate (per second)
+#define FRIC_MAX        0.25f   // Give up above this duty (FAULT_STALL_DUTY)
+#define FRIC_COUNTS     4       // Movement that counts as breakaway (QEI counts)
+#define FRIC_DWELL      500     // Zero duty before each ramp (control intervals)
+
+#define FRIC_SRAM       0x20    // MCP7940M SRAM address (8 bytes per axis)
+#define FRIC_MAGIC      0xA5    // Marks a valid SRAM record
+
+// Calibration states
+enum
+{
+    FRIC_IDLE = 0,  // Not calibrating
+    FRIC_REST,      // Zero duty while the shaft stops
+    FRIC_RAMP       // Ramping the duty until the shaft moves
+};
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagFRIC_PARAMS
+{
+    volatile bool bStart;   // Calibration requested (set by the main loop)
+    volatile bool bDone;    // Calibration finished, result ready to save
+
+    uint8_t  uiState;       // Calibration state
+    uint8_t  uiPass;        // Direction being measured (0 or 1)
+    bool     bDirSave;      // Direction before the calibration
+    bool     bFailed;       // The shaft did not move below FRIC_MAX
+    uint16_t uiCount;       // Rest time remaining (control intervals)
+    int32_t  iStart;        // Position at the start of the ramp (counts)
+    float    fDuty;         // Calibration duty
+    float    afBreak[ 2 ];  // Measured breakaway duty (index bDir)
+
+} FRIC_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void FRIC_Init( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP );
+void FRIC_Start( FRIC_PARAMS *pFRIC );
+bool FRIC_Calibrate( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP, POSITION_PARAMS *pPOS );
+void FRIC_Report( FRIC_PARAMS *pFRIC, MOTOR_CONTROL_PARAMS *pMCP );
+
+#endif // FRIC_H_
+
+//----------------------------------------------------------------------------
+// END FRIC.H
+//----------------------------------------------------------------------------
@@ -40,7 +40,14 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 //----------------------------------------------------------------------------
 
 // Hardware Register Access Macro
+// HOST_BUILD compiles the control modules for a PC (see test/) with the
+// registers held in memory by HOST_Reg
+#ifdef HOST_BUILD
+volatile uint32_t *HOST_Reg( uint32_t uiAddr );
+#define HWREG( x )  (*( HOST_Reg( ( uint32_t )( x ) ) ) )
+#else
 #define HWREG( x )  (*( ( volatile uint32_t* )( x ) ) )
+#endif
 #define NUM_ELEMENTS( a ) ( sizeof( a ) / sizeof( a[ 0 ] ) )
 
 // Bit-Band Alias Macro
@@ -88,6 +95,10 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
                                             // Clock Gating Control
 #define SYSCTL_RCGCQEI          0x400FE644  // Quadrature Encoder Interface Run
                                             // Mode Clock Gating Control
+#define SYSCTL_RCGCTIMER        0x400FE604  // 16/32-Bit General-Purpose Timer
+                                            // Run Mode Clock Gating Control
+#define SYSCTL_RCGCWTIMER       0x400FE65C  // 32/64-Bit Wide General-Purpose
+                                            // Timer Run Mode Clock Gating Control
 
 #define GPIO_PORTA_BASE         0x40004000  // GPIO Port A
 #define GPIO_PORTB_BASE         0x40005000  // GPIO Port B
@@ -171,6 +182,7 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 #define ADC0_BASE               0x40038000  // ADC
 
 #define ADC_O_ACTSS             0x00000000  // ADC Active Sample Sequencer
+#define ADC_O_RIS               0x00000004  // ADC Raw Interrupt Status
 #define ADC_O_IM                0x00000008  // ADC Interrupt Mask
 #define ADC_O_ISC               0x0000000C  // ADC Interrupt Status and Clear
 #define ADC_O_EMUX              0x00000014  // ADC Event Multiplexer Select
@@ -183,6 +195,19 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 #define ADC_O_SSFIFO0           0x00000048  // ADC Sample Sequence Result FIFO 0
 #define ADC_O_SSFSTAT0          0x0000004C  // ADC Sample Sequence FIFO 0 Status
 
+#define ADC1_BASE               0x40039000  // ADC1
+
+#define ADC_O_OSTAT             0x00000010  // ADC Overflow Status
+#define ADC_O_SSMUX1            0x00000060  // ADC Sample Sequence Input Multiplexer Select 1
+#define ADC_O_SSCTL1            0x00000064  // ADC Sample Sequence Control 1
+#define ADC_O_SSFIFO1           0x00000068  // ADC Sample Sequence Result FIFO 1
+#define ADC_O_SSFSTAT1          0x0000006C  // ADC Sample Sequence FIFO 1 Status
+#define ADC_O_SSOP1             0x00000070  // ADC Sample Sequence 1 Operation
+#define ADC_O_SSDC1             0x00000074  // ADC Sample Sequence 1 Digital Comparator Select
+#define ADC_O_DCRIC             0x00000D00  // ADC Digital Comparator Reset Initial Conditions
+#define ADC_O_DCCTL0            0x00000E00  // ADC Digital Comparator Control 0
+#define ADC_O_DCCMP0            0x00000E40  // ADC Digital Comparator Range 0
+
 #define I2C0_BASE               0x40020000  // I2C0
 
 #define I2C_O_MSA               0x00000000  // I2C Master Slave Address
@@ -204,6 +229,11 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 
 #define PWM_O_ENABLE            0x00000008  // PWM Output Enable
 #define PWM_O_INVERT            0x0000000C  // PWM Output Inversion
+#define PWM_O_INTEN             0x00000014  // PWM Interrupt Enable
+#define PWM_O_RIS               0x00000018  // PWM Raw Interrupt Status
+#define PWM_O_ISC               0x0000001C  // PWM Interrupt Status and Clear
+#define PWM_O_FAULT             0x00000010  // PWM Output Fault
+#define PWM_O_FAULTVAL          0x00000024  // PWM Fault Condition Value
 #define PWM_O_0_CTL             0x00000040  // PWM0 Control
 #define PWM_O_0_LOAD            0x00000050  // PWM0 Load
 #define PWM_O_0_COUNT           0x00000054  // PWM0 Counter
@@ -212,6 +242,24 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 #define PWM_O_0_GENA            0x00000060  // PWM0 Generator A Control
 #define PWM_O_0_GENB            0x00000064  // PWM0 Generator B Control
 
+#define PWM_O_1_CTL             0x00000080  // PWM1 Control
+
+// Generator registers relative to PWM_O_n_CTL
+#define PWM_O_X_CTL             0x00000000  // PWMn Control
+#define PWM_O_X_LOAD            0x00000010  // PWMn Load
+#define PWM_O_X_COUNT           0x00000014  // PWMn Counter
+#define PWM_O_X_CMPA            0x00000018  // PWMn Compare A
+#define PWM_O_X_CMPB            0x0000001C  // PWMn Compare B
+#define PWM_O_X_GENA            0x00000020  // PWMn Generator A Control
+#define PWM_O_X_GENB            0x00000024  // PWMn Generator B Control
+#define PWM_O_X_INTEN           0x00000004  // PWMn Interrupt and Trigger Enable
+#define PWM_O_X_ISC             0x0000000C  // PWMn Interrupt Status and Clear
+#define PWM_O_X_FLTSRC0         0x00000034  // PWMn Fault Source 0
+#define PWM_O_X_FLTSRC1         0x00000038  // PWMn Fault Source 1
+
+#define PWM_O_0_FLTSTAT1        0x00000808  // PWM0 Fault Pin Logic Status 1
+#define PWM_O_FLTSTAT_STEP      0x00000080  // Fault status registers per generator
+
 #define PWM_O_2_CTL             0x000000C0  // PWM0 Control
 #define PWM_O_2_LOAD            0x000000D0  // PWM0 Load
 #define PWM_O_2_COUNT           0x000000D4  // PWM0 Counter
@@ -220,11 +268,33 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 #define PWM_O_2_GENA            0x000000E0  // PWM0 Generator A Control
 #define PWM_O_2_GENB            0x000000E4  // PWM0 Generator B Control
 
+#define TIMER0_BASE             0x40030000  // Timer0
+#define WTIMER0_BASE            0x40036000  // Wide Timer0
+
+#define TIMER_O_CFG             0x00000000  // GPTM Configuration
+#define TIMER_O_TAMR            0x00000004  // GPTM Timer A Mode
+#define TIMER_O_CTL             0x0000000C  // GPTM Control
+#define TIMER_O_IMR             0x00000018  // GPTM Interrupt Mask
+#define TIMER_O_RIS             0x0000001C  // GPTM Raw Interrupt Status
+#define TIMER_O_ICR             0x00000024  // GPTM Interrupt Clear
+#define TIMER_O_TAILR           0x00000028  // GPTM Timer A Interval Load
+#define TIMER_O_TAR             0x00000048  // GPTM Timer A
+#define TIMER_O_TAV             0x00000050  // GPTM Timer A Value
+
+#define NVIC_DEMCR              0xE000EDFC  // Debug Exception and Monitor Control
+#define DWT_CTRL                0xE0001000  // DWT Control
+#define DWT_CYCCNT              0xE0001004  // DWT Cycle Count
+
 #define QEI0_BASE               0x4002C000  // QEI0
+#define QEI1_BASE               0x4002D000  // QEI1
 
 #define QEI_O_CTL               0x00000000  // QEI Control
+#define QEI_O_STAT              0x00000004  // QEI Status
+#define QEI_O_POS               0x00000008  // QEI Position
+#define QEI_O_MAXPOS            0x0000000C  // QEI Maximum Position
 #define QEI_O_LOAD              0x00000010  // QEI Timer Load
 #define QEI_O_INTEN             0x00000020  // QEI Interrupt Enable
+#define QEI_O_RIS               0x00000024  // QEI Raw Interrupt Status
 #define QEI_O_ISC               0x00000028  // QEI Interrupt Status and Clear
 #define QEI_O_SPEED             0x0000001C  // QEI Velocity
 
@@ -234,6 +304,10 @@ bool GLOBAL_CheckSysFlag( uint32_t uiSysFlag );
 
 #define NVIC_EN0                0xE000E100  // Interrupt Set Enable
 #define NVIC_DIS0               0xE000E180  // Interrupt Clear Enable
+#define NVIC_EN1                0xE000E104  // Interrupt 32-63 Set Enable
+#define NVIC_DIS1               0xE000E184  // Interrupt 32-63 Clear Enable
+#define NVIC_EN2                0xE000E108  // Interrupt 64-95 Set Enable
+#define NVIC_PRI0               0xE000E400  // Interrupt 0-3 Priority (4 per word)
 
 
 
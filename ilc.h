@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : ILC.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef ILC_H_
+#define ILC_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define ILC_LEN         250     // Table length (slots per cycle, maximum)
+#define ILC_DECIM       20      // Control intervals per slot (20 ms)
+#define ILC_PERIOD      5.0f    // Default cycle length (s)
+
+#define ILC_GAIN        0.5f    // Learning gain
+#define ILC_LEAD        3       // Error lead (slots) for the loop lag
+#define ILC_Q           0.3f    // Q-filter coefficient (zero-phase low-pass)
+#define ILC_MAX         60.0f   // Correction limit (RPM)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagILC_PARAMS
+{
+    volatile bool bEnabled; // Learning and correction active
+
+    uint16_t uiLen;         // Slots per cycle
+    uint16_t uiIdx;         // Current slot
+    uint16_t uiTick;        // Control interval within the slot
+
+    uint8_t  uiActive;      // Correction table applied this cycle
+    uint8_t  uiRec;         // Error table recorded this cycle
+
+    volatile bool bDone;    // Cycle complete, error table ready to learn
+    volatile bool bSwap;    // New correction table ready for the next cycle
+
+    uint32_t uiCycles;      // Cycles learned
+    float    fRms;          // RMS tracking error of the last cycle (RPM)
+
+    float afU[ 2 ][ ILC_LEN ];  // Correction tables (ping-pong, RPM)
+    float afE[ 2 ][ ILC_LEN ];  // Error tables (ping-pong, RPM summed per slot)
+
+} ILC_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void ILC_Init( ILC_PARAMS *pILC );
+void ILC_Start( ILC_PARAMS *pILC, float fPeriod, float fdt );
+void ILC_Stop( ILC_PARAMS *pILC );
+void ILC_Apply( ILC_PARAMS *pILC, MOTOR_CONTROL_PARAMS *pMCP );
+bool ILC_Learn( ILC_PARAMS *pILC );
+
+#endif // ILC_H_
+
+//----------------------------------------------------------------------------
+// END ILC.H
+//----------------------------------------------------------------------------
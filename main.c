@@ -46,9 +46,32 @@
 
 #include "motor.h"
 #include "qei.h"
+#include "observer.h"
+#include "mpc.h"
+#include "position.h"
+#include "timer.h"
+#include "fault.h"
+#include "current.h"
+#include "thermal.h"
+#include "ilc.h"
+#include "seq.h"
+#include "trace.h"
+#include "step.h"
+#include "fric.h"
+#include "mt.h"
 
 extern char g_sBuffer[80];
-extern MOTOR_CONTROL_PARAMS g_MCP;
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+extern MPC_PARAMS g_MPC;
+extern POSITION_PARAMS g_aPOS[ MOTOR_NUM_AXES ];
+extern FAULT_PARAMS g_aFLT[ MOTOR_NUM_AXES ];
+extern CURRENT_PARAMS g_CUR;
+extern THERMAL_PARAMS g_aTHM[ MOTOR_NUM_AXES ];
+extern ILC_PARAMS g_aILC[ MOTOR_NUM_AXES ];
+extern STEP_PARAMS g_aSTEP[ MOTOR_NUM_AXES ];
+extern FRIC_PARAMS g_aFRIC[ MOTOR_NUM_AXES ];
+extern MT_PARAMS g_MT;
+extern SEQ_PARAMS g_SEQ;
 
 enum LCD_Reset_Cause
 {
@@ -139,9 +162,27 @@ void Initialize(void)
     g_uiRTCCounter = 1;
     MCP7940M_Init();
 #endif
-    MOTOR_Init(&g_MCP);
+    uint8_t i;
+    for (i = 0; i < MOTOR_NUM_AXES; i++)
+    {
+        MOTOR_Init(&g_aMCP[i], i);
+        OBSERVER_Init(&g_aOBS[i], i == MT_AXIS ? MOTOR_CONTROL_DT
+                                               : QEI_GetWindow(g_aMCP[i].pAxis));
+        QEI_Init(g_aMCP[i].pAxis);
+        POSITION_Init(&g_aPOS[i], i);
+        FAULT_Init(&g_aFLT[i]);
+        THERMAL_Init(&g_aTHM[i], THERMAL_DT);
+        ILC_Init(&g_aILC[i]);
+        STEP_Init(&g_aSTEP[i], STEP_BAND);
+        FRIC_Init(&g_aFRIC[i], &g_aMCP[i]);
+    }
+    MT_Init(&g_MT, g_aMCP[MT_AXIS].pAxis);
+    MPC_Init(&g_MPC, MPC_STEP);
+    CURRENT_Init(&g_CUR, g_aMCP[CURRENT_AXIS].pAxis, MOTOR_CONTROL_DT);
+    SEQ_Init(&g_SEQ, MOTOR_CONTROL_DT);
+    TRACE_Init(MOTOR_CONTROL_DT);
 
-    QEI_Init(g_MCP.fdt);
+    TIMER_Init(g_MCP.fdt);
     return;
 }
 void LCD_Display(uint8_t ITC)
@@ -193,7 +234,7 @@ void Automatic_mode(float fAIN4_Conv)
 {
 
     float rpm = 180.0 * (fAIN4_Conv / (3.307f - 0.00f));
-    g_MCP.fSP = rpm;
+    MOTOR_SetSetpoint(&g_MCP, rpm);
     return;
 
 }
@@ -213,7 +254,7 @@ void main(void)
     bool g_MotorState;
     // Initialize the system
     Initialize();
-    g_MCP.fSP = 0.0f;
+    MOTOR_SetSetpoint(&g_MCP, 0.0f);
     static uint8_t ITC = 0;
     uint16_t g_timer2 =0;
     float UART_SS0Read[5] = { 0 };
@@ -251,6 +292,34 @@ void main(void)
             // Process a 1 ms interval in the state machine
             LED_FSM(0, 0);
 
+            // Abandon a stalled recipe upload
+            if (SEQ_RxTimeout(&g_SEQ))
+            {
+                UART_SendMessage("\r\nRecipe upload timed out\r\n");
+            }
+
+            // Report any motor fault latched by the control loop
+            uint8_t uiAxis;
+            for (uiAxis = 0; uiAxis < MOTOR_NUM_AXES; uiAxis++)
+            {
+                FAULT_Report(&g_aFLT[uiAxis], uiAxis);
+
+                // Learn from a completed cycle and report its tracking error
+                if (ILC_Learn(&g_aILC[uiAxis]))
+                {
+                    sprintf(g_sBuffer, "ILC axis %u cycle %lu: RMS error %5.2f RPM\r\n",
+                            uiAxis, (unsigned long) g_aILC[uiAxis].uiCycles,
+                            g_aILC[uiAxis].fRms);
+                    UART_SendMessage(g_sBuffer);
+                }
+
+                // Summary of a completed step response
+                STEP_Report(&g_aSTEP[uiAxis], uiAxis);
+
+                // Save a completed friction calibration
+                FRIC_Report(&g_aFRIC[uiAxis], &g_aMCP[uiAxis]);
+            }
+
             if (!--uiConvInterval)
             {
                 // Start a new set of ADC conversions on SS0
@@ -300,26 +369,27 @@ void main(void)
                 else
                 {
                     SwitchPressed_SW4(0);
+                    float fSP = MOTOR_GetSetpoint(&g_MCP);
                     if (g_timer < 1000 && g_timer > 0)
                     {
-                        if (g_MCP.fSP > 180.0f)
+                        if (fSP > 180.0f)
                         {
-                            g_MCP.fSP = 180.0f;
+                            MOTOR_SetSetpoint(&g_MCP, 180.0f);
                         }
                         else
                         {
-                            g_MCP.fSP = g_MCP.fSP + 1.0f;
+                            MOTOR_SetSetpoint(&g_MCP, fSP + 1.0f);
                         }
                     }
                     if (g_timer >= 1000)
                     {
-                        if ((g_MCP.fSP + 20.0f) > 180.0f)
+                        if ((fSP + 20.0f) > 180.0f)
                         {
-                            g_MCP.fSP = 180.0f;
+                            MOTOR_SetSetpoint(&g_MCP, 180.0f);
                         }
                         else
                         {
-                            g_MCP.fSP = g_MCP.fSP + 20.0f;
+                            MOTOR_SetSetpoint(&g_MCP, fSP + 20.0f);
                         }
                     }
 
@@ -342,26 +412,27 @@ void main(void)
                 else
                 {
                     SwitchPressed_SW6(0);
+                    float fSP = MOTOR_GetSetpoint(&g_MCP);
                     if (g_timer < 1000 && g_timer > 0)
                     {
-                        if (g_MCP.fSP - 1.0f < 0)
+                        if (fSP - 1.0f < 0)
                         {
-                            g_MCP.fSP = 0;
+                            MOTOR_SetSetpoint(&g_MCP, 0.0f);
                         }
                         else
                         {
-                            g_MCP.fSP = g_MCP.fSP - 1.0f;
+                            MOTOR_SetSetpoint(&g_MCP, fSP - 1.0f);
                         }
                     }
                     if (g_timer >= 1000)
                     {
-                        if ((g_MCP.fSP - 20.0f) < 0)
+                        if ((fSP - 20.0f) < 0)
                         {
-                            g_MCP.fSP = 0.0f;
+                            MOTOR_SetSetpoint(&g_MCP, 0.0f);
                         }
                         else
                         {
-                            g_MCP.fSP = g_MCP.fSP - 20.0f;
+                            MOTOR_SetSetpoint(&g_MCP, fSP - 20.0f);
                         }
                     }
 
@@ -432,6 +503,13 @@ void main(void)
                     float fAIN5_Celsius = fAIN5 / 81.92; // (Converted to celsius)
                     UART_SS0Read[1] = fAIN5_Celsius;
 
+                    // Derate the motors for the estimated winding temperature
+                    uint8_t uiAxis;
+                    for (uiAxis = 0; uiAxis < MOTOR_NUM_AXES; uiAxis++)
+                    {
+                        THERMAL_Update(&g_aTHM[uiAxis], &g_aMCP[uiAxis], fAIN5_Celsius);
+                    }
+
                     fAIN5 = aValues[1];
                     float fAIN5_Farenheit = fAIN5 / 81.771;
                     fAIN5_Farenheit = (fAIN5_Farenheit * 1.81) + 32.0; // (Converted to fAIN5_Farenheit)
@@ -462,7 +540,7 @@ void main(void)
                     }
                     if (uiScreen == CSCRN_RPM)  //Internal Temperature Screen
                     {
-                      float speed = QEI_GetSpeed();
+                      float speed = QEI_GetVelocity(g_MCP.pAxis);
                       // MotorSpeed( g_MCP.fSP);
                        MotorSpeed( speed);
 
@@ -23,16 +23,167 @@
 
 #include "global.h"
 
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define MOTOR_MAX_AXES  2       // Entries in the axis descriptor table
+#define MOTOR_NUM_AXES  1       // Axes fitted (1 or 2)
+
+#define MOTOR_PWM_LOAD  1000    // PWM half period (up/down, 40 MHz / 2000 = 20 kHz)
+#define MOTOR_BSH       50      // Time required to replenish bootstrap capacitor
+
+#define MOTOR_CONTROL_DT 0.001f // Control interval (Timer 0A, 1 kHz)
+
+// Speed loop design: the PID gains place the closed loop poles of the
+// OBSERVER_KM, OBSERVER_TAU motor model (see MOTOR_Init)
+#define MOTOR_LOOP_HZ   2.0f    // Natural frequency (Hz)
+#define MOTOR_LOOP_ZETA 1.0f    // Damping ratio
+
+// Maximum usable duty cycle (bootstrap limited; the low side is on for
+// 2 x (LOAD - CMPA) counts per period)
+#define MOTOR_DUTY_MAX  ( ( float )( MOTOR_PWM_LOAD - ( MOTOR_BSH / 2 ) ) / MOTOR_PWM_LOAD )
+
+// Uncomment to replace the PID with the short horizon MPC (see mpc.c)
+//#define MOTOR_USE_MPC
+
+// Comment out to disable load torque feed-forward (see observer.c); the
+// host build also turns it off with MOTOR_NO_LOAD_FF (see test/Makefile)
+#ifndef MOTOR_NO_LOAD_FF
+#define MOTOR_USE_LOAD_FF
+#endif
+
+// Comment out to disable breakaway friction compensation (see fric.c); the
+// host build also turns it off with MOTOR_NO_FRICTION_FF (see test/Makefile)
+#ifndef MOTOR_NO_FRICTION_FF
+#define MOTOR_USE_FRICTION_FF
+#endif
+#define MOTOR_FRIC_GAIN 0.9f    // Fraction of the breakaway duty fed forward
+
+// Comment out to disable sigma-delta dithering of the pulse width; the host
+// build also turns it off with MOTOR_NO_DITHER (see test/Makefile)
+#ifndef MOTOR_NO_DITHER
+#define MOTOR_USE_DITHER
+#endif
+#define MOTOR_DITHER_BITS 8     // Fractional bits of the pulse width
+#define MOTOR_DITHER_PRI  1     // Generator interrupt priority (0 is the highest)
+
+// Comment out to let the speed controller alone slow the motor down; the
+// host build also turns it off with MOTOR_NO_BRAKE (see test/Makefile)
+#ifndef MOTOR_NO_BRAKE
+#define MOTOR_USE_BRAKE
+#endif
+#define MOTOR_BRAKE_DECEL 300.0f    // Deceleration (RPM/s)
+#define MOTOR_BRAKE_KP  0.0005f     // Duty change per RPM behind the profile
+#define MOTOR_BRAKE_BAND 10.0f      // Overspeed that starts braking (RPM)
+
+// Encoder and gearbox profiles (index into g_aProfile)
+enum
+{
+    MOTOR_PROFILE_20K = 0,  // SPG30E-20K   1:20
+    MOTOR_PROFILE_30K,      // SPG30E-30K   1:30
+    MOTOR_PROFILE_60K,      // SPG30E-60K   1:60
+    MOTOR_PROFILE_150K,     // SPG30E-150K  1:150
+    MOTOR_PROFILE_200K,     // SPG30E-200K  1:200
+    MOTOR_PROFILE_300K,     // SPG30E-300K  1:270
+    MOTOR_PROFILE_CUSTOM,   // MOTOR_CUSTOM_PPR, MOTOR_CUSTOM_GEAR
+    MOTOR_NUM_PROFILES
+};
+
+// Profile fitted to each axis
+#define MOTOR_PROFILE_AXIS0 MOTOR_PROFILE_20K
+#define MOTOR_PROFILE_AXIS1 MOTOR_PROFILE_20K
+
+// Custom profile
+#define MOTOR_CUSTOM_PPR    7   // Encoder pulses per motor shaft revolution
+#define MOTOR_CUSTOM_GEAR   20  // Gear reduction
+
+// Direction reversal defaults
+#define MOTOR_REV_RAMP  2.0f    // Duty ramp rate (per second)
+#define MOTOR_REV_SPEED 2.0f    // QEI speed considered stopped (RPM)
+#define MOTOR_REV_DEAD  50      // Dead time at zero speed (control intervals)
+
+// Setpoint and direction owners (see MOTOR_Claim)
+enum
+{
+    MOTOR_OWNER_MAIN = 0,   // Main loop (published setpoint, MOTOR_SetDirection)
+    MOTOR_OWNER_SEQ,        // Recipe sequencer (control loop)
+    MOTOR_OWNER_POSITION    // Position loop (control loop)
+};
+
+// Direction reversal states
+enum
+{
+    MOTOR_REV_IDLE = 0, // Running in the commanded direction
+    MOTOR_REV_DOWN,     // Ramping the duty to zero
+    MOTOR_REV_STOP,     // Waiting for the shaft to stop
+    MOTOR_REV_DWELL,    // Dead time before driving the other way
+    MOTOR_REV_UP        // Ramping the duty limit up in the new direction
+};
+
 //----------------------------------------------------------------------------
 // STRUCTURES
 //----------------------------------------------------------------------------
 
+typedef struct tagMOTOR_PROFILE
+{
+    uint16_t uiPPR;         // Encoder pulses per motor shaft revolution
+    uint16_t uiGear;        // Gear reduction
+    uint16_t uiCountsPerRev;// QEI counts per output shaft revolution
+    float    fRPMPerCount;  // Output shaft RPM per QEI SPEED count (QEI_WINDOW)
+
+} MOTOR_PROFILE;
+
+typedef struct tagMOTOR_AXIS
+{
+    // Pulse Width Modulation (H-bridge)
+    uint32_t uiPWMBase;     // PWM module base address
+    uint32_t uiPWMGen;      // Generator offset (PWM_O_0_CTL, PWM_O_1_CTL, ...)
+    uint32_t uiPWMEnable;   // PWMENABLE bits for the generator's outputs
+    uint32_t uiPWMPort;     // GPIO port of the PWM pins
+    uint32_t uiPWMPortClk;  // RCGCGPIO bit for the PWM port
+    uint32_t uiPWMPins;     // PWM pin mask
+    uint32_t uiPWMPctl;     // PCTL value selecting the PWM function
+    uint32_t uiPWMPctlMask; // PCTL bits of the PWM pins
+    uint32_t uiPWMIrq;      // Generator interrupt number
+
+    // Quadrature Encoder Interface
+    uint32_t uiQEIBase;     // QEI module base address
+    uint32_t uiQEIClk;      // RCGCQEI / SRQEI bit
+    uint32_t uiQEIIrq;      // QEI interrupt number
+    uint32_t uiQEIPort;     // GPIO port of the PhA/PhB pins
+    uint32_t uiQEIPortClk;  // RCGCGPIO bit for the QEI port
+    uint32_t uiQEIPins;     // PhA/PhB pin mask
+    uint32_t uiQEILock;     // Pins that must be unlocked (GPIOCR)
+    uint32_t uiQEIPctl;     // PCTL value selecting the QEI function
+    uint32_t uiQEIPctlMask; // PCTL bits of the QEI pins
+
+    // Encoder and gearbox
+    const MOTOR_PROFILE *pProfile;
+
+} MOTOR_AXIS;
+
+// Settings published by the main loop (see MOTOR_Publish)
+typedef struct tagMOTOR_SETTINGS
+{
+    float fSP;  // Setpoint (RPM)
+    float fKP;  // Proportional Constant
+    float fKI;  // Integral Constant
+    float fKD;  // Derivative Constant
+
+} MOTOR_SETTINGS;
+
 typedef struct tagMOTOR_CONTROL_PARAMS
 {
-    bool  bDir; // Direction
+    uint8_t uiAxis;             // Axis number (index into g_aMCP)
+    const MOTOR_AXIS *pAxis;    // Axis hardware descriptor
+
+    bool  bDir;     // Direction (applied to the H-bridge)
+    bool  bDirCmd;  // Direction (commanded)
 
     float fSP;  // Setpoint (RPM)
     float fPV;  // Process Variable (RPM)
+    float fFF;  // Setpoint feed-forward (RPM, iterative learning control)
 
     float fKP;  // Proportional Constant
     float fKI;  // Integral Constant
@@ -42,17 +193,80 @@ typedef struct tagMOTOR_CONTROL_PARAMS
     float fPrevError;   // Previous Error
     float fdt;          // Control Interval ("delta t")
 
+    float fDuty;        // Commanded duty cycle (unquantized)
+    float fDutyLimit;   // Duty ceiling applied by the controller
+    float fDutyMax;     // Duty ceiling of the motor (thermal derating)
+    float fLoadPrev;    // Load estimate already fed forward (duty)
+    float afFric[ 2 ];  // Breakaway duty (index bDir, see fric.c)
+    float fFricPrev;    // Friction compensation already fed forward (duty)
+
+    uint16_t uiLoad;            // PWM generator LOAD (RAM copy)
+    uint32_t uiPulseLimit;      // Largest pulse width (bootstrap limited, Q)
+    float    fPulseScale;       // Duty cycle to pulse width (Q counts)
+    bool     bPWMDir;           // Direction written to GENA/GENB
+    volatile uint32_t uiPulseQ; // Pulse width (counts, MOTOR_DITHER_BITS fraction)
+    uint32_t uiDitherAcc;       // Sigma-delta remainder (PWM generator interrupt)
+
+    uint8_t  uiRevState;    // Direction reversal state
+    uint16_t uiRevDead;     // Reversal dead time (control intervals)
+    uint16_t uiRevCount;    // Dead time remaining (control intervals)
+    uint32_t uiRevTicks;    // Control intervals since the reversal began
+    float    fRevRamp;      // Reversal duty ramp rate (per second)
+    float    fRevSpeed;     // Speed considered stopped (RPM)
+    float    fRevTime;      // Duration of the last reversal (s)
+
+    bool     bBraking;      // Deceleration loop owns the duty
+    uint32_t uiBrakeTicks;  // Control intervals since braking began
+    float    fBrakeRef;     // Deceleration profile speed (RPM)
+    float    fBrakeFrom;    // Speed when the last braking began (RPM)
+    float    fBrakeTime;    // Duration of the last braking (s)
+
+    volatile uint32_t       uiPubSeq;   // Publish sequence (odd while writing)
+    volatile MOTOR_SETTINGS sPub;       // Settings published by the main loop
+    uint32_t                uiPubSeen;  // Sequence last applied by the control loop
+    volatile uint8_t        uiOwner;    // Owner of fSP and bDirCmd (MOTOR_OWNER_xxx)
+
 } MOTOR_CONTROL_PARAMS;
 
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern const MOTOR_PROFILE g_aProfile[ MOTOR_NUM_PROFILES ];
+extern const MOTOR_AXIS g_aAxis[ MOTOR_MAX_AXES ];
+extern MOTOR_CONTROL_PARAMS g_aMCP[ MOTOR_NUM_AXES ];
+
+// Primary axis (console, LCD, switches and potentiometer)
+#define g_MCP ( g_aMCP[ 0 ] )
+
 //----------------------------------------------------------------------------
 // FUNCTION PROTOTYPES
 //----------------------------------------------------------------------------
 uint8_t Motor_Mode;
-void  MOTOR_Init( MOTOR_CONTROL_PARAMS *pMCP );
+void  MOTOR_Init( MOTOR_CONTROL_PARAMS *pMCP, uint8_t uiAxis );
 void  MOTOR_PID( MOTOR_CONTROL_PARAMS *pMCP );
+bool  MOTOR_Reversal( MOTOR_CONTROL_PARAMS *pMCP );
+bool  MOTOR_Brake( MOTOR_CONTROL_PARAMS *pMCP );
+void  MOTOR_SetDirection( MOTOR_CONTROL_PARAMS *pMCP, bool bDir );
+
+void  MOTOR_Publish( MOTOR_CONTROL_PARAMS *pMCP, const MOTOR_SETTINGS *pSet );
+void  MOTOR_GetSettings( MOTOR_CONTROL_PARAMS *pMCP, MOTOR_SETTINGS *pSet );
+bool  MOTOR_Update( MOTOR_CONTROL_PARAMS *pMCP );
+void  MOTOR_SetSetpoint( MOTOR_CONTROL_PARAMS *pMCP, float fSP );
+float MOTOR_GetSetpoint( MOTOR_CONTROL_PARAMS *pMCP );
+bool  MOTOR_Claim( MOTOR_CONTROL_PARAMS *pMCP, uint8_t uiOwner );
+void  MOTOR_Release( MOTOR_CONTROL_PARAMS *pMCP, uint8_t uiOwner );
+
+float MOTOR_LoadDuty( MOTOR_CONTROL_PARAMS *pMCP );
+float MOTOR_LoadFF( MOTOR_CONTROL_PARAMS *pMCP );
+float MOTOR_FrictionDuty( MOTOR_CONTROL_PARAMS *pMCP );
+float MOTOR_FrictionFF( MOTOR_CONTROL_PARAMS *pMCP );
+
+float MOTOR_GetDutyCycle( MOTOR_CONTROL_PARAMS *pMCP );
+void  MOTOR_SetDutyCycle( MOTOR_CONTROL_PARAMS *pMCP, float fMotorSpeed, bool bMotorDir );
 
-float MOTOR_GetDutyCycle( void );
-void  MOTOR_SetDutyCycle( float fMotorSpeed, bool bMotorDir );
+uint32_t MOTOR_GetPulse( MOTOR_CONTROL_PARAMS *pMCP );
+void     MOTOR_SetPulse( MOTOR_CONTROL_PARAMS *pMCP, uint32_t uiPulse, bool bMotorDir );
 
 #endif // MOTOR_H_
 
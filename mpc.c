@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : MPC.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Short horizon model predictive speed control (explicit solution).
+//
+// The duty is held constant over the horizon (one control move), so for the
+// first order motor model used by the observer the predicted speed after k
+// prediction steps is:
+//
+//     y[k] = f^k * y0 + ( 1 - f^k ) * Km * u
+//
+// Minimizing
+//
+//     J = SUM( ( r - y[k] )^2 ) + RHO * ( u - uprev )^2,  k = 1..N
+//
+// gives u = Kr * r - Ky * y0 + Ku * uprev. With a single decision variable
+// the duty limits reduce the QP to three regions (below, inside and above
+// the limits), so clipping the unconstrained solution is the exact
+// constrained optimum. The gains are computed once by MPC_Init.
+//
+// The observer's load estimate d (a duty) enters the model as
+// y[k] = f^k * y0 + ( 1 - f^k ) * Km * ( u - d ). Solving for u - d in
+// place of u gives
+//
+//     u = Kr * r - Ky * y0 + Ku * uprev + ( 1 - Ku ) * d
+//
+// so the law is positional and carries the whole estimate every interval
+// (the PID's incremental MOTOR_LoadFF would decay away here). The estimate
+// is also the MPC's only integral action: built without MOTOR_USE_LOAD_FF
+// it holds a steady error under load (a 0.15 load step at 80 RPM leaves
+// it more than 2 RPM low for good, and the setpoint steps never settle).
+//
+// The breakaway friction compensation opposes motion like a load. Once the
+// shaft turns the observer's estimate already contains the friction, so d
+// is the larger of the two rather than their sum: the compensation gets a
+// start from rest past the deadband, and the estimate takes over from it.
+//
+// Against the PID on the plant simulation (test/test_control.c; Coulomb
+// friction 0.03, the profile with load torque noise):
+//
+//                  --------- PID ---------   --------- MPC ---------
+// Case               tr     OS     ts    IAE     tr     OS     ts    IAE
+// --------------   -----  ----  -----  ----   -----  ----  -----  ----
+// 0 -> 60 RPM      0.041   3.6  0.449   4.1   0.042   7.3  0.566   4.9
+// 60 -> 120 RPM    0.114   0.6  0.182   3.3   0.129   0.1  0.226   3.6
+// 120 -> 60 RPM    0.119  10.0  0.505   8.1   0.113   2.2  0.211   6.9
+// 60 -> 180 RPM    0.224   0.0  0.389  12.7   0.205   0.1  0.312  11.9
+//
+// (tr and ts in s, OS in %.) Both hold the duty at the bootstrap limit
+// (0.975) on the last step. On a conveyor cycle (0.3 s ramps to 120 RPM,
+// 0.5 s hold, 0.4 s stop) the RMS error is 16.3 RPM with the PID and
+// 17.2 RPM with the MPC; after a 0.15 load step at 80 RPM the dip is 7.2
+// against 10.8 RPM and the speed is back within 2 RPM after 0.20 against
+// 0.71 s. With its gains placed for the 1 kHz loop (MOTOR_LOOP_HZ) the PID
+// matches the MPC on rising steps and rejects load better; the MPC keeps
+// the edge where the speed comes down, settling 120 -> 60 RPM in less
+// than half the time. On the host test_control measures a call at about 7 ns for the
+// PID and 9 ns for the MPC (the lowest of five runs).
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "mpc.h"
+#include "observer.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+MPC_PARAMS g_MPC;
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : MPC_Init( MPC_PARAMS *pMPC, float fdt )
+// PURPOSE  : Computes the explicit MPC gains for prediction step fdt.
+//----------------------------------------------------------------------------
+
+void MPC_Init( MPC_PARAMS *pMPC, float fdt )
+{
+    uint16_t uiSteps = ( uint16_t )( ( fdt / OBSERVER_TS ) + 0.5f );
+    uint16_t i;
+
+    // Model decay over one prediction step
+    float f = 1.0f;
+    for( i = 0; i < uiSteps; i++ )
+    {
+        f *= ( 1.0f - ( OBSERVER_TS / OBSERVER_TAU ) );
+    }
+
+    // Accumulate the condensed prediction terms over the horizon
+    float fFk  = 1.0f;
+    float fSg  = 0.0f;
+    float fSgf = 0.0f;
+    float fSgg = 0.0f;
+    for( i = 0; i < MPC_HORIZON; i++ )
+    {
+        fFk *= f;
+        float fG = ( 1.0f - fFk ) * OBSERVER_KM;
+
+        fSg  += fG;
+        fSgf += fG * fFk;
+        fSgg += fG * fG;
+    }
+
+    float fD = fSgg + MPC_RHO;
+
+    pMPC->fKr = fSg  / fD;
+    pMPC->fKy = fSgf / fD;
+    pMPC->fKu = MPC_RHO / fD;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MPC_Control( MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Provides model predictive motor control.
+//----------------------------------------------------------------------------
+
+void MPC_Control( MOTOR_CONTROL_PARAMS *pMCP )
+{
+    // Get the current speed (observer estimate, corrected by the QEI)
+    pMCP->fPV = g_aOBS[ pMCP->uiAxis ].fSpeed;
+
+    // Load estimate (at least the friction compensation) in the prediction model
+    float fDist = MOTOR_LoadDuty( pMCP );
+    float fFric = MOTOR_FrictionDuty( pMCP );
+
+    fDist = fDist > fFric ? fDist : fFric;
+
+    float fDC = ( g_MPC.fKr * ( pMCP->fSP + pMCP->fFF ) )
+              - ( g_MPC.fKy * pMCP->fPV )
+              + ( g_MPC.fKu * pMCP->fDuty )
+              + ( ( 1.0f - g_MPC.fKu ) * fDist );
+
+    // Apply the duty limits (exact for a single control move); the upper
+    // limit is the bootstrap limit, the reversal ramp or thermal derating
+    fDC = fDC < 0.0f ? 0.0f : fDC;
+    fDC = fDC > pMCP->fDutyLimit ? pMCP->fDutyLimit : fDC;
+    fDC = fDC > pMCP->fDutyMax   ? pMCP->fDutyMax   : fDC;
+
+    pMCP->fDuty = fDC;
+    MOTOR_SetDutyCycle( pMCP, fDC, pMCP->bDir );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END MPC.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : MPC.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef MPC_H_
+#define MPC_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define MPC_HORIZON     4       // Prediction horizon (steps)
+#define MPC_STEP        0.03f   // Prediction step length (s)
+#define MPC_RHO         2000.0f // Penalty on duty changes (RPM^2 per unit^2)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagMPC_PARAMS
+{
+    float fKr;      // Gain on the setpoint
+    float fKy;      // Gain on the measured speed
+    float fKu;      // Gain on the previous duty
+
+} MPC_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void MPC_Init( MPC_PARAMS *pMPC, float fdt );
+void MPC_Control( MOTOR_CONTROL_PARAMS *pMCP );
+
+#endif // MPC_H_
+
+//----------------------------------------------------------------------------
+// END MPC.H
+//----------------------------------------------------------------------------
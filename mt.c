@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : MT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// M/T (count and period) output shaft speed measurement.
+//
+// PD6 is the QEI0 PhA input and cannot also be a timer capture, so the
+// encoder PhA signal is wired in parallel to PC4 (WT0CCP0). Wide Timer 0A
+// timestamps each rising edge against the system clock.
+//
+// Every control interval the edges that arrived (M) are divided by the
+// exact time between the last edge of the previous measurement and the
+// last edge now (T). At low speed this is the period of a single edge; at
+// high speed it is a count over close to one control interval with
+// edge-exact timing, so the measurement moves smoothly from one method to
+// the other with neither the window lag nor the one-count quantisation of
+// the QEI velocity. Rising edges only are used so the PhA duty cycle does
+// not show up as ripple.
+//
+// Without a new edge the speed can be no more than one edge over the time
+// since the last one; the measurement falls to that bound, and to zero
+// after MT_TIMEOUT.
+//
+// Measured on the plant simulation (test/test_mt.c), open loop with load
+// noise of 5 % of the drive: RMS error against the shaft speed, and the
+// mean delay behind it over a +50 % speed step (the area between the two
+// over the step height).
+//
+//     Speed      Window 150 ms         M/T           Observer on M/T
+//     (RPM)     RMS     latency    RMS    latency     RMS    latency
+//       2      0.28     173 ms    0.04    160 ms     0.05    0.7 ms
+//       5      0.16     156 ms    0.08     66 ms     0.08    0.8 ms
+//      20      0.49     151 ms    0.13     17 ms     0.13    0.9 ms
+//      60      1.27     151 ms    0.15      6 ms     0.16    1.0 ms
+//     130      2.70     150 ms    0.16      3 ms     0.19    1.0 ms
+//
+// The limit is the edge period: M/T cannot see a change before the next
+// PhA edge. Below about 3 RPM an edge comes less often than a window ends
+// (214 ms apart at 2 RPM), so M/T is barely ahead of the window there and
+// falling back to it would gain nothing; the observer axis 0 controls on
+// predicts through the wait from the duty.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "mt.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+MT_PARAMS g_MT;
+
+//----------------------------------------------------------------------------
+// FUNCTION : WTIMER0A_IntHandler( void )
+// PURPOSE  : Interrupt handler for Wide Timer 0A (PhA rising edge)
+//----------------------------------------------------------------------------
+
+void WTIMER0A_IntHandler( void )
+{
+    // Acknowledge the interrupt
+    HWREG( WTIMER0_BASE + TIMER_O_ICR ) = ( 1 << 2 );
+
+    g_MT.uiStamp = HWREG( WTIMER0_BASE + TIMER_O_TAR );
+    g_MT.uiEdges++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MT_Init( MT_PARAMS *pMT, const MOTOR_AXIS *pAxis )
+// PURPOSE  : Configures the PhA edge capture (PC4, Wide Timer 0A).
+//----------------------------------------------------------------------------
+
+void MT_Init( MT_PARAMS *pMT, const MOTOR_AXIS *pAxis )
+{
+    // One rising PhA edge per encoder pulse
+    pMT->fScale = ( 60.0f * MT_CLOCK ) / ( pAxis->pProfile->uiPPR * pAxis->pProfile->uiGear );
+
+    pMT->uiEdges     = 0;
+    pMT->uiStamp     = 0;
+    pMT->uiEdgesPrev = 0;
+    pMT->uiStampPrev = 0;
+    pMT->bValid      = false;
+    pMT->fSpeed      = 0.0f;
+
+    HWREG( SYSCTL_RCGCWTIMER ) |= 0x00000001; // Enable Clock for Wide Timer 0
+    HWREG( SYSCTL_RCGCGPIO )   |= 0x00000004; // Enable Clock for Port C
+
+    // PC4 as WT0CCP0
+    HWREG( GPIO_PORTC_BASE + GPIO_O_DEN   ) |=  0x10;
+    HWREG( GPIO_PORTC_BASE + GPIO_O_DIR   ) &= ~0x10;
+    HWREG( GPIO_PORTC_BASE + GPIO_O_AFSEL ) |=  0x10;
+    HWREG( GPIO_PORTC_BASE + GPIO_O_PCTL  ) &= ~0x000F0000;
+    HWREG( GPIO_PORTC_BASE + GPIO_O_PCTL  ) |=  0x00070000;
+
+    // Timer A: 32-bit, edge-time capture, counting up, rising edges
+    HWREG( WTIMER0_BASE + TIMER_O_CTL   ) = 0;
+    HWREG( WTIMER0_BASE + TIMER_O_CFG   ) = 0x00000004;
+    HWREG( WTIMER0_BASE + TIMER_O_TAMR  ) = 0x00000017;
+    HWREG( WTIMER0_BASE + TIMER_O_TAILR ) = 0xFFFFFFFF;
+
+    // Interrupt on each capture (IRQ 94) and start the timer
+    HWREG( WTIMER0_BASE + TIMER_O_ICR ) = ( 1 << 2 );
+    HWREG( WTIMER0_BASE + TIMER_O_IMR ) = ( 1 << 2 );
+    HWREG( NVIC_EN2 ) = ( 1 << ( 94 - 64 ) );
+    HWREG( WTIMER0_BASE + TIMER_O_CTL ) = ( 1 << 0 );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MT_Update( MT_PARAMS *pMT )
+// PURPOSE  : Measures the speed (control loop, every tick). Returns true if
+//            fSpeed holds a new measurement.
+//----------------------------------------------------------------------------
+
+bool MT_Update( MT_PARAMS *pMT )
+{
+    // The edge interrupt has the same priority, so it cannot run in between
+    uint32_t uiEdges = pMT->uiEdges;
+    uint32_t uiStamp = pMT->uiStamp;
+    uint32_t uiNum   = uiEdges - pMT->uiEdgesPrev;
+
+    if( uiNum )
+    {
+        bool bValid = pMT->bValid;
+
+        // Edges over the time they span (the first edge only starts timing)
+        if( bValid ) pMT->fSpeed = ( uiNum * pMT->fScale ) / ( uiStamp - pMT->uiStampPrev );
+
+        pMT->uiEdgesPrev = uiEdges;
+        pMT->uiStampPrev = uiStamp;
+        pMT->bValid      = true;
+
+        return bValid;
+    }
+
+    if( !pMT->bValid ) return false;
+
+    uint32_t uiElapsed = HWREG( WTIMER0_BASE + TIMER_O_TAV ) - pMT->uiStampPrev;
+
+    if( uiElapsed >= ( uint32_t )( MT_TIMEOUT * MT_CLOCK ) )
+    {
+        pMT->fSpeed = 0.0f;
+        pMT->bValid = false;
+        return true;
+    }
+
+    // Slower than one edge over the time since the last one
+    float fBound = pMT->fScale / uiElapsed;
+    if( fBound < pMT->fSpeed )
+    {
+        pMT->fSpeed = fBound;
+        return true;
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------
+// END MT.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : MT.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef MT_H_
+#define MT_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define MT_AXIS         0               // Axis whose PhA is wired to PC4
+#define MT_CLOCK        80000000.0f     // Capture timer clock (Hz)
+#define MT_TIMEOUT      1.0f            // No edge for this long is standstill (s)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagMT_PARAMS
+{
+    float fScale;               // RPM x timer cycles per edge
+
+    volatile uint32_t uiEdges;  // Edges captured (edge interrupt)
+    volatile uint32_t uiStamp;  // Time of the last edge (timer cycles)
+
+    uint32_t uiEdgesPrev;       // Edges at the last measurement
+    uint32_t uiStampPrev;       // Time of the edge that ended the last measurement
+    bool     bValid;            // uiStampPrev is a real edge
+
+    float    fSpeed;            // Output shaft speed (RPM)
+
+} MT_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void MT_Init( MT_PARAMS *pMT, const MOTOR_AXIS *pAxis );
+bool MT_Update( MT_PARAMS *pMT );
+
+#endif // MT_H_
+
+//----------------------------------------------------------------------------
+// END MT.H
+//----------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : OBSERVER.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Steady-state Kalman speed observer with load torque (disturbance)
+// estimation.
+//
+// The motor is modelled as a first order system driven by the applied duty
+// less the load torque, expressed as the duty needed to overcome it:
+//
+//     w[k+1] = w[k] + ( Ts / Tau ) * ( Km * ( u[k] - d[k] ) - w[k] )
+//
+// The load is modelled as constant between corrections. A speed lower than
+// predicted means more load: each correction moves d by a share of the
+// load change that explains the speed error (error / Km). The share is
+// chosen so a load error decays with OBSERVER_TD whatever the correction
+// interval: a load error d leaves a speed error of about
+// Km * ( 1 - Phi ) * d / ( L + 1 - Phi ) at each correction, where Phi is
+// the model decay over the interval and L the speed gain. Scaling the share
+// with the interval alone would leave the M/T axis, with its high speed
+// gain, taking many seconds to learn a load.
+//
+// The model is run every control interval to predict the output shaft
+// speed between QEI windows. At the end of each window the QEI measurement
+// (the average speed over the window) is compared against the average of
+// the predictions over the same window and the estimate is corrected with
+// a fixed gain. An axis with edge timing (see mt.c) is corrected every
+// control interval that produced an M/T measurement instead.
+//
+// RMS error against the shaft speed on the plant simulation (PID in closed
+// loop, load torque noise; test/test_observer.c):
+//
+// Case                 QEI window  Observer/QEI  Observer/MT
+// ------------------   ----------  ------------  -----------
+// 20 RPM                 1.24         1.49          0.60
+// 65 RPM                 0.96         1.44          0.18
+// 130 RPM                0.96         1.40          0.11
+// 65-130 RPM, load      11.17         3.79          0.22
+//
+// At a steady speed the 1 kHz loop cancels most of the load noise with
+// the duty, so the shaft hardly moves and the window count is close; the
+// observer corrected once a window predicts those duty moves as speed
+// changes until the next correction. It pays off when the speed moves,
+// and the M/T corrected observer is better throughout.
+//
+// A prediction is two multiplies and four adds; test_observer measures
+// about 5 ns per control interval on the host, the lowest of five runs
+// (see TRACE_Dump for the target).
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "observer.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : OBSERVER_Init( OBSERVER_PARAMS *pOBS, float fWindow )
+// PURPOSE  : Observer initialization. fWindow is the correction interval (s):
+//            the QEI window, or the control interval for an axis corrected
+//            by the M/T speed measurement (see mt.c).
+//----------------------------------------------------------------------------
+
+void OBSERVER_Init( OBSERVER_PARAMS *pOBS, float fWindow )
+{
+    uint16_t uiSteps = ( uint16_t )( ( fWindow / OBSERVER_TS ) + 0.5f );
+    uint16_t i;
+
+    pOBS->fA = OBSERVER_TS / OBSERVER_TAU;
+    pOBS->fB = OBSERVER_KM * pOBS->fA;
+
+    // Noise scaled to the correction interval
+    float fQ = OBSERVER_Q * ( fWindow / OBSERVER_T_REF );
+
+    // State transition over one correction interval
+    float fPhi = 1.0f;
+    for( i = 0; i < uiSteps; i++ )
+    {
+        fPhi *= ( 1.0f - pOBS->fA );
+    }
+
+    // Iterate the scalar Riccati equation at the window rate until the gain
+    // settles; this runs once so the ISR only applies a fixed gain
+    float fP = OBSERVER_R;
+    float fK = 0.0f;
+    for( i = 0; i < 100; i++ )
+    {
+        float fPm = ( fPhi * fPhi * fP ) + fQ;
+        fK = fPm / ( fPm + OBSERVER_R );
+        fP = ( 1.0f - fK ) * fPm;
+    }
+    pOBS->fL = fK;
+
+    // Load gain for the load estimate time constant
+    pOBS->fLD = ( fWindow / OBSERVER_TD ) * ( fK + 1.0f - fPhi ) / ( 1.0f - fPhi );
+    pOBS->uiSteps = uiSteps ? uiSteps : 1;
+
+    pOBS->fSpeed = 0.0f;
+    pOBS->fDist  = 0.0f;
+    pOBS->fSum   = 0.0f;
+    pOBS->uiN    = 0;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : OBSERVER_Predict( OBSERVER_PARAMS *pOBS, float fDuty )
+// PURPOSE  : Advances the speed estimate by one tick using the applied duty.
+//----------------------------------------------------------------------------
+
+void OBSERVER_Predict( OBSERVER_PARAMS *pOBS, float fDuty )
+{
+    pOBS->fSpeed += ( pOBS->fB * ( fDuty - pOBS->fDist ) ) - ( pOBS->fA * pOBS->fSpeed );
+
+    // Accumulate the prediction for comparison with the window average
+    pOBS->fSum += pOBS->fSpeed;
+    pOBS->uiN++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : OBSERVER_Correct( OBSERVER_PARAMS *pOBS, float fMeasured )
+// PURPOSE  : Corrects the estimate with a speed measurement (RPM) averaged
+//            since the previous correction.
+//----------------------------------------------------------------------------
+
+void OBSERVER_Correct( OBSERVER_PARAMS *pOBS, float fMeasured )
+{
+    float fPredicted = pOBS->uiN ? ( pOBS->fSum / pOBS->uiN ) : pOBS->fSpeed;
+    float fInnov = fMeasured - fPredicted;
+
+    // An M/T measurement can span several control intervals at low speed:
+    // the gains are per interval. The first one after a stop spans the
+    // whole stop, hence the limit.
+    float fSpan = ( pOBS->uiN > pOBS->uiSteps ) ? ( float )pOBS->uiN / pOBS->uiSteps : 1.0f;
+    if( fSpan > OBSERVER_SPAN_MAX ) fSpan = OBSERVER_SPAN_MAX;
+    float fL    = pOBS->fL * fSpan;
+
+    pOBS->fSpeed += ( fL < 1.0f ? fL : 1.0f ) * fInnov;
+
+    pOBS->fDist -= pOBS->fLD * fSpan * ( fInnov / OBSERVER_KM );
+    if( pOBS->fDist >  OBSERVER_DMAX ) pOBS->fDist =  OBSERVER_DMAX;
+    if( pOBS->fDist < -OBSERVER_DMAX ) pOBS->fDist = -OBSERVER_DMAX;
+
+    pOBS->fSum = 0.0f;
+    pOBS->uiN  = 0;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END OBSERVER.C
+//----------------------------------------------------------------------------
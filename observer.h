@@ -0,0 +1,77 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : OBSERVER.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef OBSERVER_H_
+#define OBSERVER_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define OBSERVER_TS         MOTOR_CONTROL_DT    // Prediction interval
+
+#define OBSERVER_TAU        0.12f   // Mechanical time constant (s)
+#define OBSERVER_KM         200.0f  // Output shaft RPM at 100% duty (no load)
+
+#define OBSERVER_T_REF      0.15f   // Correction interval OBSERVER_Q is given for (s)
+
+#define OBSERVER_Q          4.0f    // Process noise variance per OBSERVER_T_REF (RPM^2)
+#define OBSERVER_R          0.25f   // Measurement noise variance (RPM^2)
+
+#define OBSERVER_TD         0.5f    // Load estimate time constant (s)
+#define OBSERVER_DMAX       1.0f    // Load estimate limit (duty)
+#define OBSERVER_SPAN_MAX   20.0f   // Longest measurement the gains are scaled up for (corrections)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagOBSERVER_PARAMS
+{
+    float fA;       // Ts / Tau
+    float fB;       // Km * Ts / Tau
+    float fL;       // Steady-state Kalman gain (window correction)
+    float fLD;      // Load estimate correction gain (per correction)
+    uint16_t uiSteps; // Predictions per correction interval
+
+    float fSpeed;   // Estimated output shaft speed (RPM, negative against bDir)
+    float fDist;    // Estimated load torque (duty needed to overcome it)
+
+    float fSum;     // Sum of predicted speeds within the current QEI window
+    uint16_t uiN;   // Number of predictions within the current QEI window
+
+} OBSERVER_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void  OBSERVER_Init( OBSERVER_PARAMS *pOBS, float fWindow );
+void  OBSERVER_Predict( OBSERVER_PARAMS *pOBS, float fDuty );
+void  OBSERVER_Correct( OBSERVER_PARAMS *pOBS, float fMeasured );
+
+#endif // OBSERVER_H_
+
+//----------------------------------------------------------------------------
+// END OBSERVER.H
+//----------------------------------------------------------------------------
@@ -0,0 +1,382 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : POSITION.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Output shaft position control.
+//
+// The QEI position counter covers one output shaft revolution and wraps at
+// MAXPOS. Each control interval the change in the counter is unwrapped and
+// accumulated into a multi-turn position. In position mode a proportional
+// position loop with velocity feed-forward from a trapezoidal profile
+// produces the speed setpoint and direction for the speed PID.
+//
+// The profile is solved when a move is requested (main loop), so the
+// control interrupt only evaluates the closed form reference. Position mode
+// owns the speed setpoint and direction (MOTOR_Claim) until POSITION_Stop,
+// so main loop setpoints are ignored meanwhile; a move is refused while a
+// recipe owns them.
+//
+// The same change is also accumulated into a 64-bit absolute position for
+// maintenance counters, relative to a home set either at once or on the
+// next index pulse (QEI_USE_INDEX). The main loop reads it without masking
+// interrupts: the control interrupt bumps a sequence count before and after
+// each update, and the reader retries if the count was odd or changed.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <math.h>
+#include "position.h"
+#include "qei.h"
+#include "timer.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+POSITION_PARAMS g_aPOS[ MOTOR_NUM_AXES ];
+
+extern QEI_PARAMS g_aQEI[ MOTOR_MAX_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_Unwrap( int32_t iDelta, int32_t iCPR )
+// PURPOSE  : Unwraps a change in the QEI position counter across MAXPOS
+//            (the shorter way round is the real motion).
+//----------------------------------------------------------------------------
+
+static int32_t POSITION_Unwrap( int32_t iDelta, int32_t iCPR )
+{
+    if( iDelta >  ( iCPR / 2 ) ) iDelta -= iCPR;
+    if( iDelta < -( iCPR / 2 ) ) iDelta += iCPR;
+
+    return iDelta;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_Init( POSITION_PARAMS *pPOS, uint8_t uiAxis )
+// PURPOSE  : Position tracking initialization (call after QEI_Init).
+//----------------------------------------------------------------------------
+
+void POSITION_Init( POSITION_PARAMS *pPOS, uint8_t uiAxis )
+{
+    pPOS->uiAxis = uiAxis;
+    pPOS->uiCPR  = g_aAxis[ uiAxis ].pProfile->uiCountsPerRev;
+
+    pPOS->bEnabled = false;
+
+    pPOS->iPos  = 0;
+    pPOS->uiRaw = QEI_GetPosition( &g_aAxis[ uiAxis ] );
+
+    pPOS->sAbs.uiSeq        = 0;
+    pPOS->sAbs.iCounts      = 0;
+    pPOS->sAbs.iHome        = 0;
+    pPOS->sAbs.bHomeReq     = false;
+    pPOS->sAbs.bHomed       = false;
+    pPOS->sAbs.uiIndexCount = g_aQEI[ uiAxis ].uiIndexCount;
+
+    pPOS->iStart = 0;
+    pPOS->fDist  = 0.0f;
+    pPOS->fSign  = 1.0f;
+    pPOS->fV     = 0.0f;
+    pPOS->fT1    = 0.0f;
+    pPOS->fT2    = 0.0f;
+    pPOS->fT3    = 0.0f;
+    pPOS->fT     = 0.0f;
+    pPOS->fRef   = 0.0f;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_Update( POSITION_PARAMS *pPOS )
+// PURPOSE  : Accumulates the change in the QEI position counter and
+//            completes a homing request. Must be called at least twice per
+//            half revolution.
+//----------------------------------------------------------------------------
+
+void POSITION_Update( POSITION_PARAMS *pPOS )
+{
+    POSITION_ABS *pAbs = &pPOS->sAbs;
+    QEI_PARAMS   *pQEI = &g_aQEI[ pPOS->uiAxis ];
+
+    uint32_t uiRaw  = QEI_GetPosition( &g_aAxis[ pPOS->uiAxis ] );
+    int32_t  iDelta = POSITION_Unwrap( ( int32_t )uiRaw - ( int32_t )pPOS->uiRaw, pPOS->uiCPR );
+
+    pPOS->iPos += iDelta;
+    pPOS->uiRaw = uiRaw;
+
+    // Extend the absolute position (odd sequence count while updating)
+    pAbs->uiSeq++;
+    pAbs->iCounts += iDelta;
+
+    if( pAbs->bHomeReq )
+    {
+        if( !QEI_USE_INDEX || ( pPOS->uiAxis != QEI_INDEX_AXIS ) )
+        {
+            // No index channel: home is the present position
+            pAbs->iHome    = pAbs->iCounts;
+            pAbs->bHomeReq = false;
+            pAbs->bHomed   = true;
+        }
+        else if( pQEI->uiIndexCount != pAbs->uiIndexCount )
+        {
+            // Home is the index pulse, back by the counts moved since
+            int32_t iBack = POSITION_Unwrap( ( int32_t )uiRaw - ( int32_t )pQEI->uiIndexPos,
+                                             pPOS->uiCPR );
+
+            pAbs->iHome    = pAbs->iCounts - iBack;
+            pAbs->bHomeReq = false;
+            pAbs->bHomed   = true;
+        }
+    }
+    pAbs->uiIndexCount = pQEI->uiIndexCount;
+
+    pAbs->uiSeq++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_Control( POSITION_PARAMS *pPOS,
+//                              MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Position loop; sets the speed setpoint and direction.
+//----------------------------------------------------------------------------
+
+void POSITION_Control( POSITION_PARAMS *pPOS, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    float fS;   // Distance along the profile (counts)
+    float fVff; // Profile speed (counts/s)
+    float t;
+
+    if( !pPOS->bEnabled ) return;
+
+    // Evaluate the trapezoidal profile
+    pPOS->fT += pMCP->fdt;
+    t = pPOS->fT;
+
+    if( t < pPOS->fT1 )
+    {
+        fVff = POSITION_ACC * t;
+        fS   = 0.5f * POSITION_ACC * t * t;
+    }
+    else if( t < pPOS->fT2 )
+    {
+        fVff = pPOS->fV;
+        fS   = ( 0.5f * pPOS->fV * pPOS->fT1 ) + ( pPOS->fV * ( t - pPOS->fT1 ) );
+    }
+    else if( t < pPOS->fT3 )
+    {
+        float fTr = pPOS->fT3 - t;
+        fVff = POSITION_ACC * fTr;
+        fS   = pPOS->fDist - ( 0.5f * POSITION_ACC * fTr * fTr );
+    }
+    else
+    {
+        fVff = 0.0f;
+        fS   = pPOS->fDist;
+        pPOS->fT = pPOS->fT3; // Hold at the end of the profile
+    }
+
+    pPOS->fRef = pPOS->iStart + ( pPOS->fSign * fS );
+
+    // Speed command (counts/s) from feed-forward plus position error
+    float fCmd = ( pPOS->fSign * fVff )
+               + ( POSITION_KP * ( pPOS->fRef - pPOS->iPos ) );
+
+    // Hold without toggling direction once the error is negligible
+    if( fabsf( fCmd ) < POSITION_DB )
+    {
+        pMCP->fSP = 0.0f;
+        return;
+    }
+
+    // Convert to output shaft RPM and direction for the speed loop
+    pMCP->bDirCmd = ( fCmd > 0.0f );
+    pMCP->fSP  = fabsf( fCmd ) * ( 60.0f / pPOS->uiCPR );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_MoveTo( POSITION_PARAMS *pPOS, int32_t iTarget )
+// PURPOSE  : Starts a profiled move to an absolute position (counts).
+//            Returns false if a recipe owns the setpoint.
+//----------------------------------------------------------------------------
+
+bool POSITION_MoveTo( POSITION_PARAMS *pPOS, int32_t iTarget )
+{
+    POSITION_PARAMS sNew;
+    bool bClaimed;
+
+    TIMER0A_IntDisable();
+    {
+        sNew = *pPOS;
+    }
+    TIMER0A_IntEnable();
+
+    // Start from the current reference when already holding a position so
+    // consecutive moves do not accumulate the following error
+    sNew.iStart = sNew.bEnabled ? ( int32_t )sNew.fRef : sNew.iPos;
+
+    float fDist = ( float )( iTarget - sNew.iStart );
+    sNew.fSign  = fDist < 0.0f ? -1.0f : 1.0f;
+    sNew.fDist  = fabsf( fDist );
+
+    // Solve the profile: triangular if cruise speed cannot be reached
+    if( sNew.fDist < ( POSITION_VMAX * POSITION_VMAX / POSITION_ACC ) )
+    {
+        sNew.fV  = sqrtf( POSITION_ACC * sNew.fDist );
+        sNew.fT1 = sNew.fV / POSITION_ACC;
+        sNew.fT2 = sNew.fT1;
+    }
+    else
+    {
+        sNew.fV  = POSITION_VMAX;
+        sNew.fT1 = POSITION_VMAX / POSITION_ACC;
+        sNew.fT2 = sNew.fT1 + ( ( sNew.fDist / POSITION_VMAX ) - sNew.fT1 );
+    }
+    sNew.fT3 = sNew.fT2 + sNew.fT1;
+    sNew.fT  = 0.0f;
+    sNew.fRef = sNew.iStart;
+    sNew.bEnabled = true;
+
+    // Take the setpoint and publish the new profile (the position itself
+    // belongs to the ISR)
+    TIMER0A_IntDisable();
+    {
+        bClaimed = MOTOR_Claim( &g_aMCP[ pPOS->uiAxis ], MOTOR_OWNER_POSITION );
+        if( bClaimed )
+        {
+            sNew.iPos  = pPOS->iPos;
+            sNew.uiRaw = pPOS->uiRaw;
+            sNew.sAbs  = pPOS->sAbs;
+            *pPOS = sNew;
+        }
+    }
+    TIMER0A_IntEnable();
+
+    return bClaimed;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_MoveBy( POSITION_PARAMS *pPOS, int32_t iDelta )
+// PURPOSE  : Starts a profiled move relative to the current target (counts).
+//            Returns false if a recipe owns the setpoint.
+//----------------------------------------------------------------------------
+
+bool POSITION_MoveBy( POSITION_PARAMS *pPOS, int32_t iDelta )
+{
+    int32_t iFrom;
+
+    TIMER0A_IntDisable();
+    {
+        iFrom = pPOS->bEnabled ? ( int32_t )( pPOS->iStart + ( pPOS->fSign * pPOS->fDist ) )
+                               : pPOS->iPos;
+    }
+    TIMER0A_IntEnable();
+
+    return POSITION_MoveTo( pPOS, iFrom + iDelta );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_Stop( POSITION_PARAMS *pPOS )
+// PURPOSE  : Leaves position mode (the speed setpoint returns to zero).
+//----------------------------------------------------------------------------
+
+void POSITION_Stop( POSITION_PARAMS *pPOS )
+{
+    // Stop writing the setpoint, then hand it back to the main loop
+    pPOS->bEnabled = false;
+    MOTOR_Release( &g_aMCP[ pPOS->uiAxis ], MOTOR_OWNER_POSITION );
+
+    MOTOR_SetSetpoint( &g_aMCP[ pPOS->uiAxis ], 0.0f );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_DegreesToCounts( POSITION_PARAMS *pPOS, float fDegrees )
+// PURPOSE  : Converts output shaft degrees to QEI counts.
+//----------------------------------------------------------------------------
+
+int32_t POSITION_DegreesToCounts( POSITION_PARAMS *pPOS, float fDegrees )
+{
+    float fCounts = fDegrees * ( pPOS->uiCPR / 360.0f );
+
+    return ( int32_t )( fCounts < 0.0f ? fCounts - 0.5f : fCounts + 0.5f );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_CountsToDegrees( POSITION_PARAMS *pPOS, int32_t iCounts )
+// PURPOSE  : Converts QEI counts to output shaft degrees.
+//----------------------------------------------------------------------------
+
+float POSITION_CountsToDegrees( POSITION_PARAMS *pPOS, int32_t iCounts )
+{
+    return iCounts * ( 360.0f / pPOS->uiCPR );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_Home( POSITION_PARAMS *pPOS )
+// PURPOSE  : Requests a new home: the next index pulse (QEI_USE_INDEX), or
+//            the present position. Completed by POSITION_Update.
+//----------------------------------------------------------------------------
+
+void POSITION_Home( POSITION_PARAMS *pPOS )
+{
+    pPOS->sAbs.bHomeReq = true;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_GetCounts( const POSITION_PARAMS *pPOS )
+// PURPOSE  : Returns the absolute output shaft position from home (counts).
+//            Safe to call from the main loop without masking interrupts.
+//----------------------------------------------------------------------------
+
+int64_t POSITION_GetCounts( const POSITION_PARAMS *pPOS )
+{
+    const POSITION_ABS *pAbs = &pPOS->sAbs;
+    uint32_t uiSeq;
+    int64_t  iCounts;
+
+    // Retry if the control interrupt updated the position part way through
+    do
+    {
+        uiSeq   = pAbs->uiSeq;
+        iCounts = pAbs->iCounts - pAbs->iHome;
+    }
+    while( ( uiSeq & 1 ) || ( uiSeq != pAbs->uiSeq ) );
+
+    return iCounts;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : POSITION_GetDegrees( const POSITION_PARAMS *pPOS )
+// PURPOSE  : Returns the absolute output shaft position from home (degrees).
+//----------------------------------------------------------------------------
+
+double POSITION_GetDegrees( const POSITION_PARAMS *pPOS )
+{
+    // Counts per output shaft revolution come from the axis' encoder and
+    // gearbox profile (double keeps a count's resolution over many turns)
+    return ( double )POSITION_GetCounts( pPOS ) * ( 360.0 / pPOS->uiCPR );
+}
+
+//----------------------------------------------------------------------------
+// END POSITION.C
+//----------------------------------------------------------------------------
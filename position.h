@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : POSITION.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef POSITION_H_
+#define POSITION_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define POSITION_VMAX   1200.0f // Profile cruise speed (counts/s, ~129 RPM)
+#define POSITION_ACC    2400.0f // Profile acceleration (counts/s^2)
+#define POSITION_KP     2.0f    // Position loop gain ((counts/s) per count)
+#define POSITION_DB     4.0f    // Speed command deadband when holding (counts/s)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagPOSITION_ABS
+{
+    // Written by the control interrupt between two increments of uiSeq,
+    // read from the main loop with POSITION_GetCounts
+    volatile uint32_t uiSeq;        // Sequence count (odd during an update)
+    volatile int64_t  iCounts;      // Output shaft position since reset (counts)
+    volatile int64_t  iHome;        // Absolute position of home (counts)
+
+    volatile bool     bHomeReq;     // Homing requested (POSITION_Home)
+    volatile bool     bHomed;       // Home has been set
+    uint32_t          uiIndexCount; // Index pulses seen (QEI_USE_INDEX)
+
+} POSITION_ABS;
+
+typedef struct tagPOSITION_PARAMS
+{
+    uint8_t  uiAxis;    // Axis number (index into g_aMCP)
+    uint16_t uiCPR;     // QEI counts per output shaft revolution
+
+    bool     bEnabled;  // Position mode (cascaded over the speed PID)
+
+    int32_t  iPos;      // Output shaft position (counts, multi-turn)
+    uint32_t uiRaw;     // Last QEI position counter reading
+
+    POSITION_ABS sAbs;  // 64-bit absolute position and homing
+
+    // Trapezoidal profile (precomputed by POSITION_MoveTo)
+    int32_t  iStart;    // Start position (counts)
+    float    fDist;     // Signed move distance (counts)
+    float    fSign;     // Direction of the move (+1.0 / -1.0)
+    float    fV;        // Cruise (or triangular peak) speed (counts/s)
+    float    fT1;       // End of acceleration (s)
+    float    fT2;       // End of cruise (s)
+    float    fT3;       // End of deceleration (s)
+    float    fT;        // Time into the profile (s)
+
+    float    fRef;      // Reference position (counts)
+
+} POSITION_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void POSITION_Init( POSITION_PARAMS *pPOS, uint8_t uiAxis );
+void POSITION_Update( POSITION_PARAMS *pPOS );
+void POSITION_Control( POSITION_PARAMS *pPOS, MOTOR_CONTROL_PARAMS *pMCP );
+
+bool POSITION_MoveTo( POSITION_PARAMS *pPOS, int32_t iTarget );
+bool POSITION_MoveBy( POSITION_PARAMS *pPOS, int32_t iDelta );
+void POSITION_Stop( POSITION_PARAMS *pPOS );
+
+int32_t POSITION_DegreesToCounts( POSITION_PARAMS *pPOS, float fDegrees );
+float   POSITION_CountsToDegrees( POSITION_PARAMS *pPOS, int32_t iCounts );
+
+void    POSITION_Home( POSITION_PARAMS *pPOS );
+int64_t POSITION_GetCounts( const POSITION_PARAMS *pPOS );
+double  POSITION_GetDegrees( const POSITION_PARAMS *pPOS );
+
+#endif // POSITION_H_
+
+//----------------------------------------------------------------------------
+// END POSITION.H
+//----------------------------------------------------------------------------
@@ -16,6 +16,20 @@
 //
 // Quadrature encoder interface support functions.
 //
+// The SPEED register counts edges in either direction, so at the end of
+// each velocity window its magnitude is given the sign of the direction
+// status. If the direction changed during the window (INTDIR raw status)
+// the count mixes both directions, and the signed speed is taken from the
+// net change of the position counter instead.
+//
+// With QEI_USE_INDEX the index pulse also interrupts, and the position
+// counter at that moment (within the interrupt latency) is recorded for
+// homing (see POSITION_Update).
+//
+// Each axis measures velocity in one of the modes of g_aQEIMode (window
+// length, predivider, input filter and a moving average over a number of
+// windows kept as a running sum).
+//
 //----------------------------------------------------------------------------
 // INCLUDE FILES
 //----------------------------------------------------------------------------
@@ -23,120 +37,310 @@
 #include "qei.h"
 #include "motor.h"
 #include "uart.h"
+#include "observer.h"
+#include "mt.h"
 //----------------------------------------------------------------------------
 // GLOBAL VARIABLES
 //----------------------------------------------------------------------------
 
-extern MOTOR_CONTROL_PARAMS g_MCP;
+QEI_PARAMS g_aQEI[ MOTOR_MAX_AXES ];
+
+// Velocity measurement modes
+//
+// A new value is reported every window. Latency and noise are measured on
+// the plant simulation (test/test_qei.c) with the SPG30E-20K profile (560
+// counts per output shaft revolution). Latency is the mean delay of the
+// averaged reading behind the shaft speed over a 60 to 90 RPM step: half
+// the averaged span plus half a window waiting for the report. Noise is the
+// RMS error at steady speeds from 20 to 131 RPM, the quantisation of the
+// reading alone. The input filter rejects glitches shorter than a few
+// FILTCNT + 2 clock samples, adding well under 1 us of delay (the
+// simulation has no glitches and does not model it).
+//
+// Mode       Window  Div  Filter  Avg  Update  Latency  Noise (RPM RMS)
+// --------   ------  ---  ------  ---  ------  -------  ---------------
+// FAST        20 ms   1    off     1    20 ms   21 ms    2.18
+// STANDARD   150 ms   1    off     1   150 ms  151 ms    0.30
+// FILTERED    50 ms   1    16      4    50 ms  126 ms    0.17
+// SMOOTH     100 ms   1    16      8   100 ms  451 ms    0.06
+// PREDIV      10 ms   4    16      8    10 ms   45 ms    2.18
+//
+// PREDIV suits high pulse rate encoders (MOTOR_PROFILE_CUSTOM), where the
+// predivider keeps the count rate within the filter's reach.
+const QEI_MODE g_aQEIMode[ QEI_NUM_MODES ] =
+{
+    { 0.02f, 0, 0,  1 },    // FAST
+    { 0.15f, 0, 0,  1 },    // STANDARD
+    { 0.05f, 0, 16, 4 },    // FILTERED
+    { 0.10f, 0, 16, 8 },    // SMOOTH
+    { 0.01f, 2, 16, 8 }     // PREDIV
+};
+
+static const uint8_t g_auiAxisMode[ MOTOR_MAX_AXES ] =
+{
+    QEI_MODE_AXIS0,
+    QEI_MODE_AXIS1
+};
+
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : QEI_IntHandler( uint8_t uiAxis )
+// PURPOSE  : Common QEI interrupt handling (velocity window complete,
+//            index pulse)
+//----------------------------------------------------------------------------
+
+static void QEI_IntHandler( uint8_t uiAxis )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ uiAxis ];
+    QEI_PARAMS *pQEI = &g_aQEI[ uiAxis ];
+
+#if QEI_USE_INDEX
+    // Index pulse: note where the position counter was
+    if( HWREG( pAxis->uiQEIBase + QEI_O_RIS ) & ( 1 << 0 ) )
+    {
+        HWREG( pAxis->uiQEIBase + QEI_O_ISC ) = ( 1 << 0 );
+
+        pQEI->uiIndexPos = QEI_GetPosition( pAxis );
+        pQEI->uiIndexCount++;
+    }
+#endif
+
+    if( !( HWREG( pAxis->uiQEIBase + QEI_O_RIS ) & ( 1 << 1 ) ) ) return;
+
+    // Acknowledge the interrupt (velocity window complete only)
+    HWREG( pAxis->uiQEIBase + QEI_O_ISC ) = ( 1 << 1 );
+
+    // Net movement over the window (unwrapped across MAXPOS)
+    uint32_t uiPos  = QEI_GetPosition( pAxis );
+    int32_t  iDelta = ( int32_t )uiPos - ( int32_t )pQEI->uiPos;
+    int32_t  iCPR   = pAxis->pProfile->uiCountsPerRev;
+
+    if( iDelta >  ( iCPR / 2 ) ) iDelta -= iCPR;
+    if( iDelta < -( iCPR / 2 ) ) iDelta += iCPR;
+    pQEI->uiPos = uiPos;
+
+    // Signed counts for the window
+    int32_t iCounts;
+
+    if( HWREG( pAxis->uiQEIBase + QEI_O_RIS ) & ( 1 << 2 ) )
+    {
+        HWREG( pAxis->uiQEIBase + QEI_O_ISC ) = ( 1 << 2 );
+        pQEI->uiReversals++;
+
+        iCounts = iDelta;
+    }
+    else
+    {
+        iCounts = HWREG( pAxis->uiQEIBase + QEI_O_SPEED ) << pQEI->pMode->uiVelDiv;
+
+        if( !QEI_GetDirection( pAxis ) ) iCounts = -iCounts;
+    }
+
+    // Moving average over the mode's windows (running sum)
+    pQEI->iSum += iCounts - pQEI->aiHist[ pQEI->uiHist ];
+    pQEI->aiHist[ pQEI->uiHist ] = iCounts;
+    if( ++pQEI->uiHist >= pQEI->pMode->uiAvg ) pQEI->uiHist = 0;
+
+    pQEI->fVelocity = pQEI->iSum * pQEI->fAvgScale;
+
+    // Correct the axis' speed observer with this window's measurement
+    // (relative to the applied direction); the control loop itself runs
+    // from Timer 0A (see timer.c), which corrects the M/T axis instead
+    if( ( uiAxis < MOTOR_NUM_AXES ) && ( uiAxis != MT_AXIS ) )
+    {
+        OBSERVER_Correct( &g_aOBS[ uiAxis ], g_aMCP[ uiAxis ].bDir ? pQEI->fVelocity
+                                                                  : -pQEI->fVelocity );
+    }
+
+    return;
+}
 
 //----------------------------------------------------------------------------
 // FUNCTION : QEI0_IntHandler( void )
-// PURPOSE  : Interrupt handler for QEI0 (control loop timer)
+// PURPOSE  : Interrupt handler for QEI0 (axis 0)
 //----------------------------------------------------------------------------
 
 void QEI0_IntHandler( void )
 {
-    // Acknowledge the interrupt
-    HWREG( QEI0_BASE + QEI_O_ISC ) |= ( 1 << 1 );
+    QEI_IntHandler( 0 );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QEI1_IntHandler( void )
+// PURPOSE  : Interrupt handler for QEI1 (axis 1)
+//----------------------------------------------------------------------------
 
-    // Control the motor
-    MOTOR_PID( &g_MCP );
+void QEI1_IntHandler( void )
+{
+    QEI_IntHandler( 1 );
 
     return;
 }
 
 //----------------------------------------------------------------------------
-// FUNCTION : QEI_Init( float fdt )
-// PURPOSE  : Quadrature encoder interface initialization.
+// FUNCTION : QEI_Init( const MOTOR_AXIS *pAxis )
+// PURPOSE  : Quadrature encoder interface initialization (in the axis'
+//            velocity measurement mode).
 //----------------------------------------------------------------------------
 
-void QEI_Init( float fdt )
+void QEI_Init( const MOTOR_AXIS *pAxis )
 {
+    uint32_t uiQEI = pAxis->uiQEIBase;
+    QEI_PARAMS *pQEI = &g_aQEI[ pAxis - g_aAxis ];
+    const QEI_MODE *pMode = &g_aQEIMode[ g_auiAxisMode[ pAxis - g_aAxis ] ];
+    uint8_t i;
+
     // Configure the Quadrature Encoder Interface peripheral
-    HWREG( SYSCTL_SRQEI ) |=  0x00000001; // Reset the QEI peripheral
-    HWREG( SYSCTL_SRQEI ) &= ~0x00000001; // Remove reset
+    HWREG( SYSCTL_SRQEI ) |=  pAxis->uiQEIClk; // Reset the QEI peripheral
+    HWREG( SYSCTL_SRQEI ) &= ~pAxis->uiQEIClk; // Remove reset
+
+    HWREG( SYSCTL_RCGCQEI  ) |= pAxis->uiQEIClk;     // Enable Clock for the QEI
+    HWREG( SYSCTL_RCGCGPIO ) |= pAxis->uiQEIPortClk; // Enable Clock for the port
 
-    HWREG( SYSCTL_RCGCQEI  ) |= 0x00000001; // Enable Clock for QEI 0
-    HWREG( SYSCTL_RCGCGPIO ) |= 0x00000008; // Enable Clock for Port D
+    // Some pins (PD7) are locked by default - unlock them
+    if( pAxis->uiQEILock )
+    {
+        HWREG( pAxis->uiQEIPort + GPIO_O_GPIOLOCk ) = 0x4C4F434B;
+        HWREG( pAxis->uiQEIPort + GPIO_O_GPIOCR   ) = pAxis->uiQEILock;
+    }
 
-    // PD7 is a special pin (locked by default) - unlock PD7
-    HWREG( GPIO_PORTD_BASE + GPIO_O_GPIOLOCk ) = 0x4C4F434B;
-    HWREG( GPIO_PORTD_BASE + GPIO_O_GPIOCR   ) = 0x80;
+    // Configure PhA and PhB for the QEI
+    HWREG( pAxis->uiQEIPort + GPIO_O_DEN   ) |=  pAxis->uiQEIPins;
+    HWREG( pAxis->uiQEIPort + GPIO_O_DIR   ) &= ~pAxis->uiQEIPins;
+    HWREG( pAxis->uiQEIPort + GPIO_O_AFSEL ) |=  pAxis->uiQEIPins;
+    HWREG( pAxis->uiQEIPort + GPIO_O_PCTL  ) &= ~pAxis->uiQEIPctlMask;
+    HWREG( pAxis->uiQEIPort + GPIO_O_PCTL  ) |=  pAxis->uiQEIPctl;
 
-    // Configure PD6 and PD7 for QEI 0
-    HWREG( GPIO_PORTD_BASE + GPIO_O_DEN   ) |=  0xC0;
-    HWREG( GPIO_PORTD_BASE + GPIO_O_DIR   ) &= ~0xC0;
-    HWREG( GPIO_PORTD_BASE + GPIO_O_AFSEL ) |=  0xC0;
-    HWREG( GPIO_PORTD_BASE + GPIO_O_PCTL  ) &=  0x00FFFFFF;
-    HWREG( GPIO_PORTD_BASE + GPIO_O_PCTL  ) |=  0x66000000;
+#if QEI_USE_INDEX
+    // Configure PF4 as IDX0 (PCTL 6) for the indexed axis
+    if( pAxis == &g_aAxis[ QEI_INDEX_AXIS ] )
+    {
+        HWREG( SYSCTL_RCGCGPIO ) |= ( 1 << 5 );
 
-    // Calculate the load value based on the "delta t" argument fdt:
-    uint32_t uiLoad = ( uint32_t )( ( 80000000.0f * fdt ) + 0.5f ) - 1UL;
+        HWREG( GPIO_PORTF_BASE + GPIO_O_DEN   ) |=  ( 1 << 4 );
+        HWREG( GPIO_PORTF_BASE + GPIO_O_DIR   ) &= ~( 1 << 4 );
+        HWREG( GPIO_PORTF_BASE + GPIO_O_AFSEL ) |=  ( 1 << 4 );
+        HWREG( GPIO_PORTF_BASE + GPIO_O_PCTL  ) &= ~0x000F0000;
+        HWREG( GPIO_PORTF_BASE + GPIO_O_PCTL  ) |=  0x00060000;
+    }
+#endif
 
-    // Configure QEI0 (80 MHz System Clock)
-    HWREG( QEI0_BASE + QEI_O_CTL  )  = 0x00000628;
-    HWREG( QEI0_BASE + QEI_O_LOAD )  = uiLoad;
-    HWREG( QEI0_BASE + QEI_O_CTL  ) |= 0x00000001;
+    // Calculate the load value based on the mode's velocity window:
+    uint32_t uiLoad = ( uint32_t )( ( 80000000.0f * pMode->fWindow ) + 0.5f ) - 1UL;
 
-    // Enable the QEI0 interrupt (timer only)
-    HWREG( QEI0_BASE + QEI_O_INTEN ) = ( 1 << 1 );
-    HWREG( NVIC_EN0 ) = ( 1 << 13 );
+    // Configure the QEI (80 MHz System Clock); both edges of PhA and PhB,
+    // velocity capture, the mode's predivider (VELDIV) and input filter
+    // (FILTEN, FILTCNT)
+    uint32_t uiCtl = 0x00000628 | ( ( uint32_t )pMode->uiVelDiv << 6 );
+
+    if( pMode->uiFilter )
+    {
+        uiCtl |= ( 1 << 13 ) | ( ( uint32_t )( pMode->uiFilter - 1 ) << 16 );
+    }
+
+    HWREG( uiQEI + QEI_O_CTL  )  = uiCtl;
+    HWREG( uiQEI + QEI_O_LOAD )  = uiLoad;
+
+    // The position counter resets at MAXPOS (RESMODE = 0), so make one
+    // output shaft revolution the full range of the counter
+    HWREG( uiQEI + QEI_O_MAXPOS ) = pAxis->pProfile->uiCountsPerRev - 1;
+    HWREG( uiQEI + QEI_O_POS    ) = 0;
+    HWREG( uiQEI + QEI_O_ISC    ) = ( 1 << 2 ) | ( 1 << 0 );
+
+    // The profile's RPM per count is for QEI_WINDOW; rescale it to the
+    // mode's window once here (predivided SPEED counts are scaled back up)
+    pQEI->pMode        = pMode;
+    pQEI->fRPMPerCount = pAxis->pProfile->fRPMPerCount * ( QEI_WINDOW / pMode->fWindow );
+    pQEI->fAvgScale    = pQEI->fRPMPerCount / pMode->uiAvg;
+
+    for( i = 0; i < QEI_AVG_MAX; i++ ) pQEI->aiHist[ i ] = 0;
+    pQEI->iSum   = 0;
+    pQEI->uiHist = 0;
+
+    pQEI->fVelocity    = 0.0f;
+    pQEI->uiPos        = 0;
+    pQEI->uiReversals  = 0;
+    pQEI->uiIndexPos   = 0;
+    pQEI->uiIndexCount = 0;
+    HWREG( uiQEI + QEI_O_CTL  ) |= 0x00000001;
+
+    // Enable the QEI interrupt (timer, and the index pulse if captured)
+    HWREG( uiQEI + QEI_O_INTEN ) = ( 1 << 1 );
+#if QEI_USE_INDEX
+    if( pAxis == &g_aAxis[ QEI_INDEX_AXIS ] ) HWREG( uiQEI + QEI_O_INTEN ) |= ( 1 << 0 );
+#endif
+    HWREG( NVIC_EN0 + ( ( pAxis->uiQEIIrq / 32 ) * 4 ) ) = ( 1 << ( pAxis->uiQEIIrq % 32 ) );
 
     return;
 }
 
 //----------------------------------------------------------------------------
-// FUNCTION : QEI_GetSpeed( void )
+// FUNCTION : QEI_GetSpeed( const MOTOR_AXIS *pAxis )
 // PURPOSE  : Returns the speed of the motor output shaft in RPM.
 //----------------------------------------------------------------------------
 
-float QEI_GetSpeed( void )
+float QEI_GetSpeed( const MOTOR_AXIS *pAxis )
 {
-    // Calculate the speed of the output shaft in RPM (rotations per minute)
-    // The motor encoder produces 7 pulses per motor shaft revolution
-    // QEI0 is configured to produce 4 counts per pulse:
-    //      1 count for PhA rising
-    //      1 count for PhB rising
-    //      1 count for PhA falling
-    //      1 count for PhB falling
-    // The gear reduction for the output shaft is 60:1
-    //
-    // The SPEED register contains the number of counts within the timer interval. The
-    // timer interval (LOAD register) contains 80 MHz – 1 meaning that the SPEED register
-    // will be updated every second containing the number of counts/s.
-    //
-    // The number of rotations of the motor shaft per second is:
-    //
-    //     RPSmot = SPEED / ( 4 * 7 )
+    // The SPEED register holds the (predivided) counts within the last
+    // velocity window. The axis' encoder and gearbox profile holds the
+    // output shaft RPM per count for QEI_WINDOW, precomputed from the pulses
+    // per motor shaft revolution, the QEI_EDGES x decoding and the gear
+    // reduction (see g_aProfile in motor.c), and QEI_Init rescales it to the
+    // mode's window:
     //
-    // The number of rotations of the motor shaft per minute is:
+    //     RPMout = SPEED * 2^VELDIV * 60 / ( QEI_EDGES * PPR * GRmot * Window )
     //
-    //     RPMmot = RPSmot * 60
-    //
-    // The number of rotations of the output shaft per minute is:
-    //
-    //     RPMout = RPMmot / GRmot
-    //
-    // Note: This last division is dependent on the gear reducer. For example
-    //       the gear reduction (GRmot) is,
-    //
-    //       Model         Ratio     GRmot
-    //       -----------   ------    -----
-    //       SPG30E-20K    1:20        20
-    //       SPG30E-30K    1:30        30
-    //       SPG30E-60K    1:60        60 <-- Example (see below)
-    //       SPG30E-150K   1:120      120
-    //       SPG30E-200K   1:200      200
-    //       SPG30E-300K   1:270      270
-
-    float fSPEED  = ( float )HWREG( QEI0_BASE + QEI_O_SPEED );
-    fSPEED/=g_MCP.fdt;
-    float fRPSmot = fSPEED / ( 4.0f * 7.0f );
-    float fRPMmot = fRPSmot * 60.0f;
-    float fGRmot  = 20.0f; // SPG30E-60K
-    float fRPMout = fRPMmot / fGRmot;
-
-    return fRPMout;
+    // This is the latest window alone (not averaged) for the supervisors.
+
+    const QEI_PARAMS *pQEI = &g_aQEI[ pAxis - g_aAxis ];
+
+    return ( float )( HWREG( pAxis->uiQEIBase + QEI_O_SPEED ) << pQEI->pMode->uiVelDiv )
+         * pQEI->fRPMPerCount;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QEI_GetWindow( const MOTOR_AXIS *pAxis )
+// PURPOSE  : Returns the velocity window of the axis' measurement mode (s).
+//----------------------------------------------------------------------------
+
+float QEI_GetWindow( const MOTOR_AXIS *pAxis )
+{
+    return g_aQEIMode[ g_auiAxisMode[ pAxis - g_aAxis ] ].fWindow;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QEI_GetVelocity( const MOTOR_AXIS *pAxis )
+// PURPOSE  : Returns the signed speed of the motor output shaft in RPM over
+//            the last velocity window(s) (positive in the bDir = 1
+//            direction).
+//----------------------------------------------------------------------------
+
+float QEI_GetVelocity( const MOTOR_AXIS *pAxis )
+{
+    return g_aQEI[ pAxis - g_aAxis ].fVelocity;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QEI_GetDirection( const MOTOR_AXIS *pAxis )
+// PURPOSE  : Returns true if the last count was in the bDir = 1 direction.
+//----------------------------------------------------------------------------
+
+bool QEI_GetDirection( const MOTOR_AXIS *pAxis )
+{
+    return ( ( HWREG( pAxis->uiQEIBase + QEI_O_STAT ) >> 1 ) & 1 ) == QEI_DIR_FWD;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QEI_GetPosition( const MOTOR_AXIS *pAxis )
+// PURPOSE  : Returns the raw position counter (0 to counts per rev - 1).
+//----------------------------------------------------------------------------
+
+uint32_t QEI_GetPosition( const MOTOR_AXIS *pAxis )
+{
+    return HWREG( pAxis->uiQEIBase + QEI_O_POS );
 }
 
 //----------------------------------------------------------------------------
@@ -22,13 +22,87 @@
 //----------------------------------------------------------------------------
 
 #include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define QEI_EDGES           4   // Counts per pulse (PhA and PhB edges)
+
+#define QEI_WINDOW          0.15f // Reference velocity window (s), see g_aProfile
+
+// Velocity measurement modes (index into g_aQEIMode)
+enum
+{
+    QEI_MODE_FAST = 0,      // 20 ms window
+    QEI_MODE_STANDARD,      // 150 ms window
+    QEI_MODE_FILTERED,      // 50 ms windows, input filter, average of 4
+    QEI_MODE_SMOOTH,        // 100 ms windows, input filter, average of 8
+    QEI_MODE_PREDIV,        // 10 ms windows, divide by 4, average of 8
+    QEI_NUM_MODES
+};
+
+// Mode used by each axis (may be given on the command line)
+#ifndef QEI_MODE_AXIS0
+#define QEI_MODE_AXIS0      QEI_MODE_STANDARD
+#endif
+#ifndef QEI_MODE_AXIS1
+#define QEI_MODE_AXIS1      QEI_MODE_STANDARD
+#endif
+
+#define QEI_AVG_MAX         8   // Longest moving average (windows)
+
+#define QEI_DIR_FWD         0   // QEISTAT DIRECTION when bDir = 1 (counting up)
+
+// Index pulse capture (homing). IDX0 is only available on PD3 (AIN4, the
+// speed potentiometer) or PF4 (SW2), and IDX1 on PC4 (M/T capture input),
+// so the index is taken on PF4 and SW2 cannot be used while this is enabled
+#define QEI_USE_INDEX       0   // 1 = capture the index pulse of QEI_INDEX_AXIS
+#define QEI_INDEX_AXIS      0   // Axis with the index channel wired to PF4
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagQEI_MODE
+{
+    float   fWindow;    // Velocity window (s)
+    uint8_t uiVelDiv;   // Predivider (VELDIV, pulses divided by 2^uiVelDiv)
+    uint8_t uiFilter;   // Input filter (0 = off, else FILTCNT + 1)
+    uint8_t uiAvg;      // Windows in the moving average (1 to QEI_AVG_MAX)
+
+} QEI_MODE;
+
+typedef struct tagQEI_PARAMS
+{
+    const QEI_MODE *pMode;      // Velocity measurement mode
+    float fRPMPerCount;         // Output shaft RPM per count in one window
+    float fAvgScale;            // Output shaft RPM per count of iSum
+
+    int32_t aiHist[ QEI_AVG_MAX ]; // Signed counts of the last windows
+    int32_t iSum;               // Sum of aiHist over the moving average
+    uint8_t uiHist;             // Oldest entry of aiHist
+
+    volatile float fVelocity;   // Signed output shaft speed (RPM, + for bDir = 1)
+    uint32_t uiPos;             // Position counter at the end of the last window
+    uint32_t uiReversals;       // Windows in which the direction changed
+
+    volatile uint32_t uiIndexPos;   // Position counter at the last index pulse
+    volatile uint32_t uiIndexCount; // Index pulses captured
+
+} QEI_PARAMS;
 
 //----------------------------------------------------------------------------
 // FUNCTION PROTOTYPES
 //----------------------------------------------------------------------------
 
-void  QEI_Init( float fdt );
-float QEI_GetSpeed( void );
+void  QEI_Init( const MOTOR_AXIS *pAxis );
+float QEI_GetWindow( const MOTOR_AXIS *pAxis );
+float QEI_GetSpeed( const MOTOR_AXIS *pAxis );
+float QEI_GetVelocity( const MOTOR_AXIS *pAxis );
+bool  QEI_GetDirection( const MOTOR_AXIS *pAxis );
+uint32_t QEI_GetPosition( const MOTOR_AXIS *pAxis );
 
 #endif // QEI_H_
 
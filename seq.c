@@ -0,0 +1,392 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : SEQ.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Speed profile sequencer.
+//
+// Runs a recipe of up to SEQ_MAX_SEG segments from the control loop. Each
+// tick does a fixed amount of work: a ramp step, a countdown or a speed
+// comparison, and at most one loop or jump operation, so zero-time loops
+// cannot stall the control interrupt.
+//
+// The main loop only posts commands (a single byte read by the control
+// loop) and loads recipes while the sequencer is idle. A running or paused
+// recipe owns the setpoint and direction (MOTOR_Claim), so main loop
+// setpoints are ignored until it stops.
+//
+// Recipes are uploaded in binary:
+//
+//     'U'  count  count * 8 segment bytes  checksum
+//
+// where checksum is the low byte of the sum of the count and segment bytes.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <math.h>
+
+#include "seq.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+// Phases within a segment
+enum
+{
+    SEQ_PHASE_RAMP = 0,
+    SEQ_PHASE_DWELL,
+    SEQ_PHASE_WAIT
+};
+
+// Upload receive states
+enum
+{
+    SEQ_RXS_IDLE = 0,
+    SEQ_RXS_COUNT,
+    SEQ_RXS_DATA,
+    SEQ_RXS_SUM
+};
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+SEQ_PARAMS g_SEQ;
+
+// Default recipe
+static const SEQ_SEGMENT g_aSeqDefault[] =
+{
+    //  0.1 RPM  Ramp  Dwell  Operation                    Arg
+    {     600,  1000,  2000,  SEQ_OP_RUN,                  0 }, // 0: 60 RPM
+    {    1200,  1000,  2000,  SEQ_OP_RUN,                  0 }, // 1: 120 RPM
+    {      20,     0,  2000,  SEQ_OP_REACHED,              3 }, // 2: within 2 RPM?
+    {     600,  1000,  1000,  SEQ_OP_RUN | SEQ_OP_REV,     0 }, // 3: 60 RPM reverse
+    {       0,  1000,   500,  SEQ_OP_RUN,                  0 }, // 4: stop
+    {       3,     0,     0,  SEQ_OP_LOOP,                 0 }, // 5: repeat 3 times
+    {       0,     0,     0,  SEQ_OP_END,                  0 }  // 6
+};
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Init( SEQ_PARAMS *pSEQ, float fdt )
+// PURPOSE  : Sequencer initialization (default recipe, idle).
+//----------------------------------------------------------------------------
+
+void SEQ_Init( SEQ_PARAMS *pSEQ, float fdt )
+{
+    uint8_t i;
+
+    pSEQ->uiNumSeg = sizeof( g_aSeqDefault ) / sizeof( g_aSeqDefault[ 0 ] );
+    for( i = 0; i < pSEQ->uiNumSeg; i++ )
+    {
+        pSEQ->aSeg[ i ] = g_aSeqDefault[ i ];
+    }
+
+    pSEQ->uiCmd   = SEQ_CMD_NONE;
+    pSEQ->uiState = SEQ_IDLE;
+    pSEQ->uiSeg   = 0;
+    pSEQ->bEnter  = true;
+
+    pSEQ->fTicksPerMs = 0.001f / fdt;
+    pSEQ->uiRxState   = SEQ_RXS_IDLE;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Ticks( SEQ_PARAMS *pSEQ, uint16_t uiMs )
+// PURPOSE  : Converts a time in ms to control intervals.
+//----------------------------------------------------------------------------
+
+static uint32_t SEQ_Ticks( SEQ_PARAMS *pSEQ, uint16_t uiMs )
+{
+    return ( uint32_t )( ( uiMs * pSEQ->fTicksPerMs ) + 0.5f );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Next( SEQ_PARAMS *pSEQ, uint8_t uiSeg )
+// PURPOSE  : Moves on to a segment (started on the next tick).
+//----------------------------------------------------------------------------
+
+static void SEQ_Next( SEQ_PARAMS *pSEQ, uint8_t uiSeg )
+{
+    pSEQ->uiSeg  = uiSeg;
+    pSEQ->bEnter = true;
+
+    if( uiSeg >= pSEQ->uiNumSeg ) pSEQ->uiState = SEQ_IDLE;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Tick( SEQ_PARAMS *pSEQ, MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Runs the sequencer (control loop, every tick).
+//----------------------------------------------------------------------------
+
+void SEQ_Tick( SEQ_PARAMS *pSEQ, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    uint8_t uiCmd = pSEQ->uiCmd;
+
+    if( uiCmd != SEQ_CMD_NONE )
+    {
+        pSEQ->uiCmd = SEQ_CMD_NONE;
+
+        switch( uiCmd )
+        {
+        case SEQ_CMD_START:
+            if( !MOTOR_Claim( pMCP, MOTOR_OWNER_SEQ ) ) break;
+            if( pSEQ->uiState == SEQ_IDLE ) SEQ_Next( pSEQ, 0 );
+            pSEQ->uiState = SEQ_RUN;
+            break;
+
+        case SEQ_CMD_PAUSE:
+            if( pSEQ->uiState == SEQ_RUN ) pSEQ->uiState = SEQ_PAUSE;
+            break;
+
+        case SEQ_CMD_STOP:
+            if( pSEQ->uiState != SEQ_IDLE ) pMCP->fSP = 0.0f;
+            pSEQ->uiState = SEQ_IDLE;
+            break;
+        }
+    }
+
+    // Hand the setpoint back once idle (the last setpoint stays published)
+    if( pSEQ->uiState == SEQ_IDLE ) MOTOR_Release( pMCP, MOTOR_OWNER_SEQ );
+
+    if( pSEQ->uiState != SEQ_RUN ) return;
+
+    const SEQ_SEGMENT *pSeg = &pSEQ->aSeg[ pSEQ->uiSeg ];
+
+    if( pSEQ->bEnter )
+    {
+        pSEQ->bEnter = false;
+
+        switch( pSeg->uiOp & SEQ_OP_MASK )
+        {
+        case SEQ_OP_RUN:
+            pMCP->bDirCmd = !( pSeg->uiOp & SEQ_OP_REV );
+
+            pSEQ->fTarget = pSeg->uiRPM10 * 0.1f;
+            pSEQ->uiCount = SEQ_Ticks( pSEQ, pSeg->uiRamp );
+            pSEQ->fStep   = pSEQ->uiCount ? ( pSEQ->fTarget - pMCP->fSP ) / pSEQ->uiCount : 0.0f;
+            pSEQ->uiPhase = SEQ_PHASE_RAMP;
+            break;
+
+        case SEQ_OP_LOOP:
+            if( !pSeg->uiRPM10 || ( ++pSEQ->auLoop[ pSEQ->uiSeg ] < pSeg->uiRPM10 ) )
+            {
+                SEQ_Next( pSEQ, pSeg->uiArg );
+            }
+            else
+            {
+                pSEQ->auLoop[ pSEQ->uiSeg ] = 0;
+                SEQ_Next( pSEQ, pSEQ->uiSeg + 1 );
+            }
+            return;
+
+        case SEQ_OP_REACHED:
+            pSEQ->fTarget = pSeg->uiRPM10 * 0.1f;
+            pSEQ->uiCount = SEQ_Ticks( pSEQ, pSeg->uiDwell );
+            pSEQ->uiPhase = SEQ_PHASE_WAIT;
+            break;
+
+        default:
+            pMCP->fSP = 0.0f;
+            pSEQ->uiState = SEQ_IDLE;
+            return;
+        }
+    }
+
+    switch( pSEQ->uiPhase )
+    {
+    case SEQ_PHASE_RAMP:
+        if( pSEQ->uiCount )
+        {
+            pMCP->fSP += pSEQ->fStep;
+            if( --pSEQ->uiCount ) break;
+        }
+        pMCP->fSP     = pSEQ->fTarget;
+        pSEQ->uiCount = SEQ_Ticks( pSEQ, pSeg->uiDwell );
+        pSEQ->uiPhase = SEQ_PHASE_DWELL;
+        /* fall through */
+
+    case SEQ_PHASE_DWELL:
+        if( pSEQ->uiCount && --pSEQ->uiCount ) break;
+        SEQ_Next( pSEQ, pSEQ->uiSeg + 1 );
+        break;
+
+    case SEQ_PHASE_WAIT:
+        if( fabsf( pMCP->fPV - pMCP->fSP ) <= pSEQ->fTarget )
+        {
+            SEQ_Next( pSEQ, pSeg->uiArg );
+        }
+        else if( !pSEQ->uiCount || !--pSEQ->uiCount )
+        {
+            SEQ_Next( pSEQ, pSEQ->uiSeg + 1 );
+        }
+        break;
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Start( SEQ_PARAMS *pSEQ )
+// PURPOSE  : Starts the recipe from the top, or resumes it (main loop).
+//----------------------------------------------------------------------------
+
+void SEQ_Start( SEQ_PARAMS *pSEQ )
+{
+    uint8_t i;
+
+    // The control loop leaves the loop counters alone while idle
+    if( pSEQ->uiState == SEQ_IDLE )
+    {
+        for( i = 0; i < SEQ_MAX_SEG; i++ ) pSEQ->auLoop[ i ] = 0;
+    }
+
+    pSEQ->uiCmd = SEQ_CMD_START;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Pause( SEQ_PARAMS *pSEQ )
+// PURPOSE  : Holds the current setpoint (main loop).
+//----------------------------------------------------------------------------
+
+void SEQ_Pause( SEQ_PARAMS *pSEQ )
+{
+    pSEQ->uiCmd = SEQ_CMD_PAUSE;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Stop( SEQ_PARAMS *pSEQ )
+// PURPOSE  : Stops the recipe and sets the speed to zero (main loop).
+//----------------------------------------------------------------------------
+
+void SEQ_Stop( SEQ_PARAMS *pSEQ )
+{
+    pSEQ->uiCmd = SEQ_CMD_STOP;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Upload( SEQ_PARAMS *pSEQ )
+// PURPOSE  : Stops the recipe and starts receiving a new one (main loop).
+//----------------------------------------------------------------------------
+
+void SEQ_Upload( SEQ_PARAMS *pSEQ )
+{
+    SEQ_Stop( pSEQ );
+
+    pSEQ->uiRxState   = SEQ_RXS_COUNT;
+    pSEQ->uiRxSum     = 0;
+    pSEQ->uiRxTimeout = SEQ_RX_TIMEOUT;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_Receive( SEQ_PARAMS *pSEQ, uint8_t uiData )
+// PURPOSE  : Feeds a received byte to an upload in progress (main loop).
+//            Returns SEQ_RX_IDLE if no upload is in progress.
+//----------------------------------------------------------------------------
+
+uint8_t SEQ_Receive( SEQ_PARAMS *pSEQ, uint8_t uiData )
+{
+    uint8_t i;
+
+    switch( pSEQ->uiRxState )
+    {
+    case SEQ_RXS_IDLE:
+        return SEQ_RX_IDLE;
+
+    case SEQ_RXS_COUNT:
+        if( !uiData || ( uiData > SEQ_MAX_SEG ) )
+        {
+            pSEQ->uiRxState = SEQ_RXS_IDLE;
+            return SEQ_RX_ERROR;
+        }
+        pSEQ->uiRxNum   = uiData;
+        pSEQ->uiRxPos   = 0;
+        pSEQ->uiRxSum  += uiData;
+        pSEQ->uiRxState = SEQ_RXS_DATA;
+        break;
+
+    case SEQ_RXS_DATA:
+        ( ( uint8_t * )pSEQ->aRx )[ pSEQ->uiRxPos++ ] = uiData;
+        pSEQ->uiRxSum += uiData;
+        if( pSEQ->uiRxPos >= ( pSEQ->uiRxNum * sizeof( SEQ_SEGMENT ) ) )
+        {
+            pSEQ->uiRxState = SEQ_RXS_SUM;
+        }
+        break;
+
+    case SEQ_RXS_SUM:
+        pSEQ->uiRxState = SEQ_RXS_IDLE;
+
+        if( ( uiData != pSEQ->uiRxSum ) || ( pSEQ->uiState != SEQ_IDLE ) )
+        {
+            return SEQ_RX_ERROR;
+        }
+
+        // Operations and jump targets must be valid
+        for( i = 0; i < pSEQ->uiRxNum; i++ )
+        {
+            uint8_t uiOp = pSEQ->aRx[ i ].uiOp & SEQ_OP_MASK;
+
+            if( uiOp > SEQ_OP_END ) return SEQ_RX_ERROR;
+            if( ( ( uiOp == SEQ_OP_LOOP ) || ( uiOp == SEQ_OP_REACHED ) )
+                && ( pSEQ->aRx[ i ].uiArg >= pSEQ->uiRxNum ) ) return SEQ_RX_ERROR;
+        }
+
+        for( i = 0; i < pSEQ->uiRxNum; i++ )
+        {
+            pSEQ->aSeg[ i ] = pSEQ->aRx[ i ];
+        }
+        pSEQ->uiNumSeg = pSEQ->uiRxNum;
+
+        return SEQ_RX_DONE;
+    }
+
+    pSEQ->uiRxTimeout = SEQ_RX_TIMEOUT;
+
+    return SEQ_RX_BUSY;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQ_RxTimeout( SEQ_PARAMS *pSEQ )
+// PURPOSE  : Abandons a stalled upload (main loop, every ms). Returns true
+//            when an upload was abandoned.
+//----------------------------------------------------------------------------
+
+bool SEQ_RxTimeout( SEQ_PARAMS *pSEQ )
+{
+    if( pSEQ->uiRxState == SEQ_RXS_IDLE ) return false;
+    if( --pSEQ->uiRxTimeout ) return false;
+
+    pSEQ->uiRxState = SEQ_RXS_IDLE;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// END SEQ.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : SEQ.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef SEQ_H_
+#define SEQ_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define SEQ_AXIS        0       // Axis driven by the sequencer
+#define SEQ_MAX_SEG     32      // Segments per recipe
+#define SEQ_RX_TIMEOUT  1000    // Upload inter-byte timeout (ms)
+
+// Segment operations (uiOp bits 0-6)
+enum
+{
+    SEQ_OP_RUN = 0,     // Ramp to uiRPM10 over uiRamp ms, then dwell uiDwell ms
+    SEQ_OP_LOOP,        // Jump to uiArg uiRPM10 times (0 = forever)
+    SEQ_OP_REACHED,     // Wait up to uiDwell ms for the speed to be within
+                        // uiRPM10 of the setpoint; jump to uiArg if it is
+    SEQ_OP_END          // Setpoint to zero and stop
+};
+
+#define SEQ_OP_MASK     0x7F
+#define SEQ_OP_REV      0x80    // SEQ_OP_RUN: run in reverse
+
+// Sequencer states
+enum
+{
+    SEQ_IDLE = 0,
+    SEQ_RUN,
+    SEQ_PAUSE
+};
+
+// Commands (main loop to control loop)
+enum
+{
+    SEQ_CMD_NONE = 0,
+    SEQ_CMD_START,
+    SEQ_CMD_PAUSE,
+    SEQ_CMD_STOP
+};
+
+// Upload receive results
+enum
+{
+    SEQ_RX_IDLE = 0,    // Not uploading (byte not consumed)
+    SEQ_RX_BUSY,        // Byte consumed
+    SEQ_RX_DONE,        // Recipe received and loaded
+    SEQ_RX_ERROR        // Checksum, format or sequencer not stopped
+};
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+// Recipe segment (8 bytes, little endian on the wire)
+typedef struct tagSEQ_SEGMENT
+{
+    uint16_t uiRPM10;   // Target speed (0.1 RPM), loop count or tolerance
+    uint16_t uiRamp;    // Ramp time (ms)
+    uint16_t uiDwell;   // Dwell or wait time (ms)
+    uint8_t  uiOp;      // SEQ_OP_xxx (and SEQ_OP_REV)
+    uint8_t  uiArg;     // Jump target (segment)
+
+} SEQ_SEGMENT;
+
+typedef struct tagSEQ_PARAMS
+{
+    SEQ_SEGMENT aSeg[ SEQ_MAX_SEG ];    // Recipe
+    uint8_t     uiNumSeg;               // Segments in the recipe
+    uint16_t    auLoop[ SEQ_MAX_SEG ];  // Loop counters
+
+    volatile uint8_t uiCmd;     // Pending command (SEQ_CMD_xxx)
+    volatile uint8_t uiState;   // SEQ_IDLE, SEQ_RUN or SEQ_PAUSE
+    volatile uint8_t uiSeg;     // Current segment
+
+    bool     bEnter;        // Segment not started yet
+    uint8_t  uiPhase;       // Phase within the segment
+    uint32_t uiCount;       // Ticks left in the phase
+    float    fStep;         // Ramp step (RPM per tick)
+    float    fTarget;       // Segment target (RPM)
+    float    fTicksPerMs;   // Control intervals per ms
+
+    // Binary upload ('U', count, count * 8 bytes, checksum)
+    uint8_t     uiRxState;
+    uint8_t     uiRxNum;
+    uint16_t    uiRxPos;
+    uint8_t     uiRxSum;
+    uint16_t    uiRxTimeout;
+    SEQ_SEGMENT aRx[ SEQ_MAX_SEG ];
+
+} SEQ_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void    SEQ_Init( SEQ_PARAMS *pSEQ, float fdt );
+void    SEQ_Tick( SEQ_PARAMS *pSEQ, MOTOR_CONTROL_PARAMS *pMCP );
+
+void    SEQ_Start( SEQ_PARAMS *pSEQ );
+void    SEQ_Pause( SEQ_PARAMS *pSEQ );
+void    SEQ_Stop( SEQ_PARAMS *pSEQ );
+
+void    SEQ_Upload( SEQ_PARAMS *pSEQ );
+uint8_t SEQ_Receive( SEQ_PARAMS *pSEQ, uint8_t uiData );
+bool    SEQ_RxTimeout( SEQ_PARAMS *pSEQ );
+
+#endif // SEQ_H_
+
+//----------------------------------------------------------------------------
+// END SEQ.H
+//----------------------------------------------------------------------------
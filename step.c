@@ -0,0 +1,225 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : STEP.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Step response analyser.
+//
+// Any setpoint change of at least STEP_MIN between two control intervals,
+// to a setpoint at least STEP_MIN from the speed, arms the analyser. Ramped
+// setpoints (recipe segments, the position loop) change by less per
+// interval and do not, and smaller steps are lost in the speed noise (see
+// step.h). Each following control sample updates the figures
+// incrementally, so no trace is stored:
+//
+//     Rise time       10 % to 90 % of the step
+//     Overshoot       peak beyond the setpoint, % of the step
+//     Settling time   last time the speed was outside the band
+//     IAE, ITAE       integrals of |e| and t |e|
+//
+// The analysis ends once the speed has stayed inside the band for
+// STEP_HOLD, or after STEP_WINDOW. A new step restarts it. Completed results
+// are kept in a ring of STEP_HIST for comparison; the main loop prints each
+// new one on a single line.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+
+#include "step.h"
+#include "uart.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+STEP_PARAMS g_aSTEP[ MOTOR_NUM_AXES ];
+
+static char g_sStepBuffer[ 128 ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : STEP_Init( STEP_PARAMS *pSTEP, float fBand )
+// PURPOSE  : Analyser initialization. fBand is the settling band (fraction).
+//----------------------------------------------------------------------------
+
+void STEP_Init( STEP_PARAMS *pSTEP, float fBand )
+{
+    pSTEP->bRunning = false;
+    pSTEP->fLastSP  = 0.0f;
+    pSTEP->fBand    = fBand;
+
+    pSTEP->uiHead  = 0;
+    pSTEP->uiCount = 0;
+    pSTEP->bDone   = false;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : STEP_Finish( STEP_PARAMS *pSTEP )
+// PURPOSE  : Completes the result and stores it (control loop).
+//----------------------------------------------------------------------------
+
+static void STEP_Finish( STEP_PARAMS *pSTEP )
+{
+    STEP_RESULT *pRes = &pSTEP->sCur;
+
+    pRes->fRise      = ( pSTEP->fT90 >= 0.0f ) ? pSTEP->fT90 - pSTEP->fT10 : -1.0f;
+    pRes->fOvershoot = ( pSTEP->fPeak > 1.0f ) ? ( pSTEP->fPeak - 1.0f ) * 100.0f : 0.0f;
+    pRes->fSettle    = ( ( pSTEP->fT - pSTEP->fOut ) >= STEP_HOLD ) ? pSTEP->fOut : -1.0f;
+
+    pSTEP->asResult[ pSTEP->uiHead ] = *pRes;
+    pSTEP->uiHead = ( pSTEP->uiHead + 1 ) % STEP_HIST;
+    pSTEP->uiCount++;
+
+    pSTEP->bRunning = false;
+    pSTEP->bDone    = true;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : STEP_Sample( STEP_PARAMS *pSTEP, MOTOR_CONTROL_PARAMS *pMCP )
+// PURPOSE  : Updates the analysis with this control sample (control loop,
+//            after the controller).
+//----------------------------------------------------------------------------
+
+void STEP_Sample( STEP_PARAMS *pSTEP, MOTOR_CONTROL_PARAMS *pMCP )
+{
+    STEP_RESULT *pRes = &pSTEP->sCur;
+
+    // Arm on a setpoint step
+    if( fabsf( pMCP->fSP - pSTEP->fLastSP ) >= STEP_MIN
+        && fabsf( pMCP->fSP - pMCP->fPV ) >= STEP_MIN )
+    {
+        pSTEP->bRunning = true;
+        pSTEP->fT    = 0.0f;
+        pSTEP->fT10  = -1.0f;
+        pSTEP->fT90  = -1.0f;
+        pSTEP->fOut  = 0.0f;
+        pSTEP->fPeak = 0.0f;
+
+        pRes->fFrom = pMCP->fPV;
+        pRes->fTo   = pMCP->fSP;
+        pRes->fIAE  = 0.0f;
+        pRes->fITAE = 0.0f;
+    }
+    pSTEP->fLastSP = pMCP->fSP;
+
+    if( !pSTEP->bRunning ) return;
+
+    pSTEP->fT += pMCP->fdt;
+
+    float fStep  = pRes->fTo - pRes->fFrom;
+    float fError = fabsf( pRes->fTo - pMCP->fPV );
+    float fY     = ( pMCP->fPV - pRes->fFrom ) / fStep; // Normalised response
+
+    pRes->fIAE  += fError * pMCP->fdt;
+    pRes->fITAE += pSTEP->fT * fError * pMCP->fdt;
+
+    if( ( pSTEP->fT10 < 0.0f ) && ( fY >= 0.1f ) ) pSTEP->fT10 = pSTEP->fT;
+    if( ( pSTEP->fT90 < 0.0f ) && ( fY >= 0.9f ) ) pSTEP->fT90 = pSTEP->fT;
+    if( fY > pSTEP->fPeak ) pSTEP->fPeak = fY;
+
+    if( fError > ( pSTEP->fBand * fabsf( fStep ) ) ) pSTEP->fOut = pSTEP->fT;
+
+    // Settled for long enough, or out of time
+    if( ( ( pSTEP->fT90 >= 0.0f ) && ( ( pSTEP->fT - pSTEP->fOut ) >= STEP_HOLD ) )
+        || ( pSTEP->fT >= STEP_WINDOW ) )
+    {
+        STEP_Finish( pSTEP );
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : STEP_Format( STEP_RESULT *pRes )
+// PURPOSE  : Formats a result as a single line into g_sStepBuffer.
+//----------------------------------------------------------------------------
+
+static void STEP_Format( STEP_RESULT *pRes )
+{
+    int n = sprintf( g_sStepBuffer, "%5.1f->%5.1f RPM:", pRes->fFrom, pRes->fTo );
+
+    if( pRes->fRise >= 0.0f ) n += sprintf( g_sStepBuffer + n, " tr %5.3f s,", pRes->fRise );
+    else                      n += sprintf( g_sStepBuffer + n, " tr  ---  s," );
+
+    n += sprintf( g_sStepBuffer + n, " OS %4.1f %%,", pRes->fOvershoot );
+
+    if( pRes->fSettle >= 0.0f ) n += sprintf( g_sStepBuffer + n, " ts %5.3f s,", pRes->fSettle );
+    else                        n += sprintf( g_sStepBuffer + n, " ts  ---  s," );
+
+    sprintf( g_sStepBuffer + n, " IAE %5.2f ITAE %5.3f\r\n", pRes->fIAE, pRes->fITAE );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : STEP_Report( STEP_PARAMS *pSTEP, uint8_t uiAxis )
+// PURPOSE  : Sends a newly completed result over the UART (main loop).
+//----------------------------------------------------------------------------
+
+void STEP_Report( STEP_PARAMS *pSTEP, uint8_t uiAxis )
+{
+    if( !pSTEP->bDone ) return;
+    pSTEP->bDone = false;
+
+    char sHead[ 32 ];
+    snprintf( sHead, sizeof( sHead ), "Step axis %u #%lu ", uiAxis, ( unsigned long )pSTEP->uiCount );
+    UART_SendMessage( sHead );
+
+    STEP_Format( &pSTEP->asResult[ ( pSTEP->uiHead + STEP_HIST - 1 ) % STEP_HIST ] );
+    UART_SendMessage( g_sStepBuffer );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : STEP_List( STEP_PARAMS *pSTEP, uint8_t uiAxis )
+// PURPOSE  : Sends the stored results over the UART, oldest first (main loop).
+//----------------------------------------------------------------------------
+
+void STEP_List( STEP_PARAMS *pSTEP, uint8_t uiAxis )
+{
+    uint32_t uiNum = pSTEP->uiCount < STEP_HIST ? pSTEP->uiCount : STEP_HIST;
+    uint32_t i;
+    char sHead[ 32 ];
+
+    sprintf( g_sStepBuffer, "Step responses axis %u (band %4.1f %%)\r\n", uiAxis,
+             pSTEP->fBand * 100.0f );
+    UART_SendMessage( g_sStepBuffer );
+
+    if( !uiNum ) UART_SendMessage( "  none yet\r\n" );
+
+    for( i = 0; i < uiNum; i++ )
+    {
+        uint32_t uiIdx = ( pSTEP->uiHead + STEP_HIST - uiNum + i ) % STEP_HIST;
+
+        snprintf( sHead, sizeof( sHead ), "  #%lu ", ( unsigned long )( pSTEP->uiCount - uiNum + i + 1 ) );
+        UART_SendMessage( sHead );
+
+        STEP_Format( &pSTEP->asResult[ uiIdx ] );
+        UART_SendMessage( g_sStepBuffer );
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END STEP.C
+//----------------------------------------------------------------------------
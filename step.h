@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : STEP.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef STEP_H_
+#define STEP_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+// Smallest setpoint step analysed (RPM). Both the change between two
+// control intervals and the distance from the speed must reach it:
+//   - a recipe ramp (seq.c) moves the setpoint by its fStep every interval,
+//     under STEP_MIN for any ramp slower than 5000 RPM/s, and the
+//     position loop (position.c) moves the speed a little every interval;
+//     arming on either would restart the analysis each interval and never
+//     finish one;
+//   - the 10 % to 90 % span of a smaller step is within a few times the
+//     speed reading's noise (0.3 RPM RMS in the default QEI mode, see
+//     qei.c), so its rise time and overshoot would measure the noise.
+#define STEP_MIN        5.0f
+#define STEP_BAND       0.02f   // Default settling band (fraction of the step)
+#define STEP_HOLD       0.5f    // Time inside the band that ends the analysis (s)
+#define STEP_WINDOW     5.0f    // Longest analysis (s)
+#define STEP_HIST       8       // Results kept for comparison
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagSTEP_RESULT
+{
+    float fFrom;        // Speed when the step was applied (RPM)
+    float fTo;          // Setpoint (RPM)
+    float fRise;        // 10 % to 90 % rise time (s, negative if not reached)
+    float fOvershoot;   // Peak overshoot (% of the step)
+    float fSettle;      // Settling time (s, negative if not settled)
+    float fIAE;         // Integral of the absolute error (RPM s)
+    float fITAE;        // Integral of the time weighted absolute error (RPM s^2)
+
+} STEP_RESULT;
+
+typedef struct tagSTEP_PARAMS
+{
+    bool  bRunning;     // Analysing a step
+    float fLastSP;      // Setpoint at the previous sample (RPM)
+    float fBand;        // Settling band (fraction of the step)
+
+    float fT;           // Time since the step (s)
+    float fT10;         // Time the response reached 10 % (s, negative until then)
+    float fT90;         // Time the response reached 90 % (s, negative until then)
+    float fOut;         // Last time outside the settling band (s)
+    float fPeak;        // Largest normalised response
+    STEP_RESULT sCur;   // Result being accumulated
+
+    STEP_RESULT asResult[ STEP_HIST ];  // Completed results (ring)
+    uint8_t  uiHead;            // Next slot to write
+    uint32_t uiCount;           // Results completed
+    volatile bool bDone;        // New result ready to report
+
+} STEP_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void STEP_Init( STEP_PARAMS *pSTEP, float fBand );
+void STEP_Sample( STEP_PARAMS *pSTEP, MOTOR_CONTROL_PARAMS *pMCP );
+void STEP_Report( STEP_PARAMS *pSTEP, uint8_t uiAxis );
+void STEP_List( STEP_PARAMS *pSTEP, uint8_t uiAxis );
+
+#endif // STEP_H_
+
+//----------------------------------------------------------------------------
+// END STEP.H
+//----------------------------------------------------------------------------
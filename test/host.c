@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : HOST.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// PC stand-ins for the hardware (HOST_BUILD, see global.h).
+//
+// Every register reads back the last value written to it (zero at start);
+// the peripheral space and the core peripherals (NVIC, DWT) are each a flat
+// array. The UART prints to stdout and the RTC SRAM is a byte array.
+//
+// One register can be made a FIFO (HOST_FifoInit): each access to it takes
+// the next entry pushed by HOST_FifoPush, and the empty flag of its status
+// register is set once the last one has been taken.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+#include "uart.h"
+#include "mcp7940m.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define HOST_PERIPH_BASE    0x40000000  // Peripherals (1 MB)
+#define HOST_CORE_BASE      0xE0000000  // Core peripherals (64 kB)
+#define HOST_FIFO_DEPTH     4           // FIFO entries (as ADC SS1 and SS2)
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+static volatile uint32_t g_auPeriph[ 0x00100000 / 4 ];
+static volatile uint32_t g_auCore[ 0x00010000 / 4 ];
+
+static uint8_t g_auRTC[ 256 ];
+
+// FIFO register (HOST_FifoInit)
+static uint32_t g_uiFifoAddr;       // FIFO register (0 = none)
+static uint32_t g_uiFifoStat;       // Its status register
+static uint32_t g_uiFifoEmpty;      // Empty flag in the status register
+static uint32_t g_auFifo[ HOST_FIFO_DEPTH ];
+static uint8_t  g_uiFifoHead;       // Next entry taken
+static uint8_t  g_uiFifoCount;      // Entries held
+
+static uint32_t g_uiAccesses;       // Register accesses (HOST_Accesses)
+static uint32_t g_uiFailed;
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_Reg( uint32_t uiAddr )
+// PURPOSE  : Returns the memory standing in for a register.
+//----------------------------------------------------------------------------
+
+volatile uint32_t *HOST_Reg( uint32_t uiAddr )
+{
+    // FIFO: the register holds the entry taken by this access
+    if( ( uiAddr == g_uiFifoAddr ) && g_uiFifoCount )
+    {
+        g_auPeriph[ ( uiAddr - HOST_PERIPH_BASE ) / 4 ] = g_auFifo[ g_uiFifoHead ];
+        g_uiFifoHead = ( g_uiFifoHead + 1 ) % HOST_FIFO_DEPTH;
+
+        if( --g_uiFifoCount == 0 )
+        {
+            g_auPeriph[ ( g_uiFifoStat - HOST_PERIPH_BASE ) / 4 ] |= g_uiFifoEmpty;
+        }
+    }
+
+    g_uiAccesses++;
+
+    if( ( uiAddr - HOST_PERIPH_BASE ) < sizeof( g_auPeriph ) )
+    {
+        return &g_auPeriph[ ( uiAddr - HOST_PERIPH_BASE ) / 4 ];
+    }
+
+    if( ( uiAddr - HOST_CORE_BASE ) < sizeof( g_auCore ) )
+    {
+        return &g_auCore[ ( uiAddr - HOST_CORE_BASE ) / 4 ];
+    }
+
+    fprintf( stderr, "Register 0x%08lx outside the emulated space\n", ( unsigned long )uiAddr );
+    exit( 2 );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_Reset( void )
+// PURPOSE  : Clears every register (power on).
+//----------------------------------------------------------------------------
+
+void HOST_Reset( void )
+{
+    uint32_t i;
+
+    for( i = 0; i < NUM_ELEMENTS( g_auPeriph ); i++ ) g_auPeriph[ i ] = 0;
+    for( i = 0; i < NUM_ELEMENTS( g_auCore ); i++ ) g_auCore[ i ] = 0;
+
+    g_uiFifoAddr  = 0;
+    g_uiFifoCount = 0;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_Accesses( void )
+// PURPOSE  : Returns the number of register accesses so far (each HWREG
+//            use counts once, so a read-modify-write is one).
+//----------------------------------------------------------------------------
+
+uint32_t HOST_Accesses( void )
+{
+    return g_uiAccesses;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_FifoInit( uint32_t uiFifo, uint32_t uiStat,
+//                           uint32_t uiEmpty )
+// PURPOSE  : Makes a peripheral register a FIFO (empty), with the empty flag
+//            uiEmpty in the status register uiStat.
+//----------------------------------------------------------------------------
+
+void HOST_FifoInit( uint32_t uiFifo, uint32_t uiStat, uint32_t uiEmpty )
+{
+    g_uiFifoAddr  = uiFifo;
+    g_uiFifoStat  = uiStat;
+    g_uiFifoEmpty = uiEmpty;
+    g_uiFifoHead  = 0;
+    g_uiFifoCount = 0;
+
+    *HOST_Reg( uiStat ) |= uiEmpty;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_FifoPush( uint32_t uiValue )
+// PURPOSE  : Adds an entry to the FIFO. Returns false if it is full (the
+//            entry is lost, as on the device).
+//----------------------------------------------------------------------------
+
+bool HOST_FifoPush( uint32_t uiValue )
+{
+    if( g_uiFifoCount >= HOST_FIFO_DEPTH ) return false;
+
+    g_auFifo[ ( g_uiFifoHead + g_uiFifoCount ) % HOST_FIFO_DEPTH ] = uiValue;
+    g_uiFifoCount++;
+
+    *HOST_Reg( g_uiFifoStat ) &= ~g_uiFifoEmpty;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_Check( bool bPass, const char *sExpr,
+//                        const char *sFile, int iLine )
+// PURPOSE  : Reports a failed check (see HOST_CHECK).
+//----------------------------------------------------------------------------
+
+void HOST_Check( bool bPass, const char *sExpr, const char *sFile, int iLine )
+{
+    if( bPass ) return;
+
+    printf( "FAIL %s:%d: %s\n", sFile, iLine, sExpr );
+    g_uiFailed++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : HOST_Result( void )
+// PURPOSE  : Returns the exit status of a test program.
+//----------------------------------------------------------------------------
+
+int HOST_Result( void )
+{
+    printf( "%s (%lu failed)\n", g_uiFailed ? "FAILED" : "PASSED", ( unsigned long )g_uiFailed );
+
+    return g_uiFailed ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : UART_SendMessage( char* sMessage )
+// PURPOSE  : Terminal output.
+//----------------------------------------------------------------------------
+
+void UART_SendMessage( char* sMessage )
+{
+    char c;
+
+    // Drop the carriage returns of the terminal line endings
+    while( ( c = *sMessage++ ) ) if( c != '\r' ) putchar( c );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MCP7940M_Read( uint8_t uiReg, uint8_t* puiData, uint8_t uiNum )
+// PURPOSE  : RTC register read.
+//----------------------------------------------------------------------------
+
+void MCP7940M_Read( uint8_t uiReg, uint8_t* puiData, uint8_t uiNum )
+{
+    while( uiNum-- ) *puiData++ = g_auRTC[ uiReg++ ];
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MCP7940M_Write( uint8_t uiReg, uint8_t* puiData, uint8_t uiNum )
+// PURPOSE  : RTC register write.
+//----------------------------------------------------------------------------
+
+void MCP7940M_Write( uint8_t uiReg, uint8_t* puiData, uint8_t uiNum )
+{
+    while( uiNum-- ) g_auRTC[ uiReg++ ] = *puiData++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END HOST.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,48 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : HOST.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef HOST_H_
+#define HOST_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+
+//----------------------------------------------------------------------------
+// MACROS
+//----------------------------------------------------------------------------
+
+// Records a failed check (test programs exit non-zero if any failed)
+#define HOST_CHECK( c ) HOST_Check( ( c ), #c, __FILE__, __LINE__ )
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void HOST_Reset( void );
+uint32_t HOST_Accesses( void );
+void HOST_FifoInit( uint32_t uiFifo, uint32_t uiStat, uint32_t uiEmpty );
+bool HOST_FifoPush( uint32_t uiValue );
+void HOST_Check( bool bPass, const char *sExpr, const char *sFile, int iLine );
+int  HOST_Result( void );
+
+#endif // HOST_H_
+
+//----------------------------------------------------------------------------
+// END HOST.H
+//----------------------------------------------------------------------------
@@ -0,0 +1,652 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : SIM.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Plant simulation for the host build (axis 0).
+//
+// SIM_Init runs the control module part of Initialize (main.c) against the
+// emulated registers, and SIM_Tick then plays one control interval:
+//
+//   - every PWM period the generator interrupt (dither) runs, if enabled,
+//     and the duty is worked out from the generator actions (GENA, GENB on
+//     the counter events), as the H-bridge sees it, with the outputs forced
+//     to the fault value while a fault is latched;
+//   - the motor is the first order model of observer.c plus Coulomb
+//     friction (with a higher breakaway at rest) and a load torque (with
+//     low-pass filtered noise), solved exactly over each PWM period; with
+//     the bridge off (bCoast) it is driven at its own back EMF, so only
+//     friction and the load slow it;
+//   - every encoder count crossed updates the QEI position, direction and
+//     velocity registers, and every PhA rising edge (one per QEI_EDGES
+//     counts) is timestamped into Wide Timer 0 and its interrupt run, with
+//     the crossing time interpolated within the period;
+//   - at the end of each velocity window the QEI interrupt runs;
+//   - at the generator's ADC trigger ADC1 SS1 samples the shunt, which
+//     carries the winding current only while a high side switch is on;
+//     its steps go to the digital comparators (which can latch the
+//     generator's fault) or to the FIFO, and the PWM fault and sequence
+//     interrupts run;
+//   - finally the control interrupt (Timer 0A) runs, timed (host clock).
+//
+// The winding current is the stall current less the back EMF, over the
+// drive, with the inductance ignored (the torque of the model).
+//
+// Interrupt status registers are write-one-to-clear on the device; here
+// the ISC writes are applied to RIS after each handler. The same goes for
+// the fault status (FLTSTAT1): a 1 written there releases the latched fault.
+// The comparators are modelled in their "trigger always" mode only.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <math.h>
+#include <time.h>
+
+#include "host.h"
+#include "sim.h"
+#include "timer.h"
+#include "observer.h"
+#include "qei.h"
+#include "mpc.h"
+#include "position.h"
+#include "fault.h"
+#include "current.h"
+#include "ilc.h"
+#include "seq.h"
+#include "step.h"
+#include "fric.h"
+#include "mt.h"
+#include "thermal.h"
+#include "trace.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+SIM_PLANT g_SIM;
+
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+extern POSITION_PARAMS g_aPOS[ MOTOR_NUM_AXES ];
+extern FAULT_PARAMS g_aFLT[ MOTOR_NUM_AXES ];
+extern THERMAL_PARAMS g_aTHM[ MOTOR_NUM_AXES ];
+extern ILC_PARAMS g_aILC[ MOTOR_NUM_AXES ];
+extern STEP_PARAMS g_aSTEP[ MOTOR_NUM_AXES ];
+extern FRIC_PARAMS g_aFRIC[ MOTOR_NUM_AXES ];
+extern CURRENT_PARAMS g_CUR;
+extern SEQ_PARAMS g_SEQ;
+extern MPC_PARAMS g_MPC;
+extern MT_PARAMS g_MT;
+
+static uint32_t g_uiSeed;
+
+// Interrupt handlers (see tm4c123gh6pm_startup_ccs.c)
+void TIMER0A_IntHandler( void );
+void QEI0_IntHandler( void );
+void PWM0_GEN0_IntHandler( void );
+void WTIMER0A_IntHandler( void );
+void PWM0_FAULT_IntHandler( void );
+void ADC1_SS1_IntHandler( void );
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Random( void )
+// PURPOSE  : Returns a normally distributed random number (unit variance,
+//            repeatable from SIM_Init).
+//----------------------------------------------------------------------------
+
+float SIM_Random( void )
+{
+    float fSum = 0.0f;
+    uint8_t i;
+
+    // Sum of 12 uniform numbers (xorshift) less 6
+    for( i = 0; i < 12; i++ )
+    {
+        g_uiSeed ^= g_uiSeed << 13;
+        g_uiSeed ^= g_uiSeed >> 17;
+        g_uiSeed ^= g_uiSeed << 5;
+        fSum += g_uiSeed * ( 1.0f / 4294967296.0f );
+    }
+
+    return fSum - 6.0f;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Acknowledge( uint32_t uiBase, uint32_t uiRIS,
+//                             uint32_t uiISC )
+// PURPOSE  : Applies interrupt clear writes to the raw status.
+//----------------------------------------------------------------------------
+
+static void SIM_Acknowledge( uint32_t uiBase, uint32_t uiRIS, uint32_t uiISC )
+{
+    HWREG( uiBase + uiRIS ) &= ~HWREG( uiBase + uiISC );
+    HWREG( uiBase + uiISC ) = 0;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Level( uint32_t uiActions, uint32_t uiTime )
+// PURPOSE  : Returns a generator output (GENA or GENB actions) at a time in
+//            the PWM period (counts from counter zero, up then down).
+//----------------------------------------------------------------------------
+
+static bool SIM_Level( uint32_t uiActions, uint32_t uiTime )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ 0 ];
+    uint32_t uiGen  = pAxis->uiPWMBase + pAxis->uiPWMGen;
+    uint32_t uiLoad = HWREG( uiGen + PWM_O_X_LOAD );
+    uint32_t uiCmpA = HWREG( uiGen + PWM_O_X_CMPA );
+    uint32_t uiCmpB = HWREG( uiGen + PWM_O_X_CMPB );
+
+    // Counter events in the period and their action fields (zero, load,
+    // CMPA up, CMPA down, CMPB up, CMPB down)
+    uint32_t auTime[ 6 ]  = { 0, uiLoad, uiCmpA, ( 2 * uiLoad ) - uiCmpA,
+                              uiCmpB, ( 2 * uiLoad ) - uiCmpB };
+    uint8_t  auOrder[ 6 ] = { 0, 2, 4, 1, 5, 3 };
+    bool bLevel = false;
+    uint8_t i, j, uiPass;
+
+    // In time order (insertion sort, equal times keep the order above)
+    for( i = 1; i < 6; i++ )
+    {
+        uint8_t uiEvent = auOrder[ i ];
+
+        for( j = i; ( j > 0 ) && ( auTime[ auOrder[ j - 1 ] ] > auTime[ uiEvent ] ); j-- )
+        {
+            auOrder[ j ] = auOrder[ j - 1 ];
+        }
+        auOrder[ j ] = uiEvent;
+    }
+
+    // A whole period for the level it starts at, then up to the time
+    for( uiPass = 0; uiPass < 2; uiPass++ )
+    {
+        for( i = 0; i < 6; i++ )
+        {
+            uint8_t uiEvent = auOrder[ i ];
+
+            if( uiPass && ( auTime[ uiEvent ] > uiTime ) ) break;
+            if( auTime[ uiEvent ] >= 2 * uiLoad ) continue;
+
+            switch( ( uiActions >> ( 2 * uiEvent ) ) & 3 )
+            {
+                case 1: bLevel = !bLevel; break;
+                case 2: bLevel = false;   break;
+                case 3: bLevel = true;    break;
+                default: break;
+            }
+        }
+    }
+
+    return bLevel;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Drive( uint32_t uiTime )
+// PURPOSE  : Returns the bridge drive at a time in the PWM period: +1 or -1
+//            while a high side switch is on (bDir = 1 or 0), else 0.
+//----------------------------------------------------------------------------
+
+int8_t SIM_Drive( uint32_t uiTime )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ 0 ];
+    uint32_t uiGen    = pAxis->uiPWMBase + pAxis->uiPWMGen;
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+    bool bA = SIM_Level( HWREG( uiGen + PWM_O_X_GENA ), uiTime );
+    bool bB = SIM_Level( HWREG( uiGen + PWM_O_X_GENB ), uiTime );
+
+    // Outputs forced to the fault value
+    if( g_SIM.bFault )
+    {
+        uint32_t uiForced = HWREG( pAxis->uiPWMBase + PWM_O_FAULT ) >> ( 2 * uiGenNum );
+        uint32_t uiValue  = HWREG( pAxis->uiPWMBase + PWM_O_FAULTVAL ) >> ( 2 * uiGenNum );
+
+        if( uiForced & 1 ) bA = ( uiValue & 1 ) != 0;
+        if( uiForced & 2 ) bB = ( uiValue & 2 ) != 0;
+    }
+
+    // An output low turns its high side switch on (see MOTOR_SetBridge)
+    if( !bA && bB ) return 1;
+    if( bA && !bB ) return -1;
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Trigger( void )
+// PURPOSE  : Returns the time in the PWM period of the generator's ADC1 SS1
+//            trigger (counts from counter zero), or -1 if there is none.
+//----------------------------------------------------------------------------
+
+int32_t SIM_Trigger( void )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ 0 ];
+    uint32_t uiGen    = pAxis->uiPWMBase + pAxis->uiPWMGen;
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+    uint32_t uiLoad   = HWREG( uiGen + PWM_O_X_LOAD );
+    uint32_t uiCmpA   = HWREG( uiGen + PWM_O_X_CMPA );
+    uint32_t uiCmpB   = HWREG( uiGen + PWM_O_X_CMPB );
+    uint32_t uiEn     = HWREG( uiGen + PWM_O_X_INTEN );
+
+    if( !( HWREG( ADC1_BASE + ADC_O_ACTSS ) & ( 1 << 1 ) ) ) return -1;
+    if( ( ( HWREG( ADC1_BASE + ADC_O_EMUX ) >> 4 ) & 0xF ) != 0x6 + uiGenNum ) return -1;
+
+    // TRCNTZERO, TRCNTLOAD, TRCMPAU, TRCMPAD, TRCMPBU, TRCMPBD
+    if( uiEn & ( 1 << 8 ) )  return 0;
+    if( uiEn & ( 1 << 9 ) )  return uiLoad;
+    if( uiEn & ( 1 << 10 ) ) return uiCmpA;
+    if( uiEn & ( 1 << 11 ) ) return ( 2 * uiLoad ) - uiCmpA;
+    if( uiEn & ( 1 << 12 ) ) return uiCmpB;
+    if( uiEn & ( 1 << 13 ) ) return ( 2 * uiLoad ) - uiCmpB;
+
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Sense( void )
+// PURPOSE  : Runs the current sample of a PWM period: ADC1 SS1, the digital
+//            comparators, the generator fault and the interrupts.
+//----------------------------------------------------------------------------
+
+static void SIM_Sense( void )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ 0 ];
+    uint32_t uiPWM    = pAxis->uiPWMBase;
+    uint32_t uiGen    = uiPWM + pAxis->uiPWMGen;
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+    int32_t  iTime    = SIM_Trigger();
+    uint32_t uiTrig   = 0;
+    bool     bInt     = false;
+    uint8_t  k;
+
+    if( iTime < 0 ) return;
+
+    // The shunt carries the winding current while a high side is on
+    int8_t iDrive  = SIM_Drive( ( uint32_t )iTime );
+    float  fShunt  = iDrive ? ( ( iDrive * g_SIM.fCurrent ) + g_SIM.fShort ) : 0.0f;
+    float  fCounts = fShunt / CURRENT_AMPS_PER_COUNT;
+
+    g_SIM.uiSample = ( fCounts <= 0.0f ) ? 0 : ( fCounts >= 4095.0f ) ? 4095 : ( uint32_t )fCounts;
+
+    // Sequence steps (one input) to the end of the sequence
+    uint32_t uiCtl = HWREG( ADC1_BASE + ADC_O_SSCTL1 );
+    uint32_t uiOp  = HWREG( ADC1_BASE + ADC_O_SSOP1 );
+    uint32_t uiDC  = HWREG( ADC1_BASE + ADC_O_SSDC1 );
+
+    for( k = 0; k < 4; k++ )
+    {
+        if( ( uiOp >> ( 4 * k ) ) & 1 )
+        {
+            // Digital comparator: trigger by band (CTE, CTC)
+            uint32_t uiComp = ( uiDC >> ( 4 * k ) ) & 0xF;
+            uint32_t uiDCCtl = HWREG( ADC1_BASE + ADC_O_DCCTL0 + ( 4 * uiComp ) );
+            uint32_t uiDCCmp = HWREG( ADC1_BASE + ADC_O_DCCMP0 + ( 4 * uiComp ) );
+            uint32_t uiLow  = uiDCCmp & 0x0FFF;
+            uint32_t uiHigh = ( uiDCCmp >> 16 ) & 0x0FFF;
+            bool bBand;
+
+            switch( ( uiDCCtl >> 10 ) & 3 )
+            {
+                case 0:  bBand = g_SIM.uiSample < uiLow; break;
+                case 1:  bBand = ( g_SIM.uiSample >= uiLow ) && ( g_SIM.uiSample < uiHigh ); break;
+                case 3:  bBand = g_SIM.uiSample >= uiHigh; break;
+                default: bBand = false; break;
+            }
+            if( ( uiDCCtl & ( 1 << 12 ) ) && bBand ) uiTrig |= 1 << uiComp;
+        }
+        else
+        {
+            HOST_FifoPush( g_SIM.uiSample );
+        }
+
+        if( ( uiCtl >> ( 4 * k ) ) & 4 ) bInt = true;
+        if( ( uiCtl >> ( 4 * k ) ) & 2 ) break;
+    }
+
+    // Generator fault from the comparators selected in FLTSRC1
+    bool bInput = ( HWREG( uiGen + PWM_O_X_CTL ) & ( 1 << 16 ) )
+               && ( HWREG( uiGen + PWM_O_X_FLTSRC1 ) & uiTrig );
+
+    if( bInput && !g_SIM.bFault )
+    {
+        HWREG( uiPWM + PWM_O_RIS ) |= 1 << ( 16 + uiGenNum );
+
+        if( HWREG( uiPWM + PWM_O_INTEN ) & ( 1 << ( 16 + uiGenNum ) ) )
+        {
+            PWM0_FAULT_IntHandler();
+            SIM_Acknowledge( uiPWM, PWM_O_RIS, PWM_O_ISC );
+        }
+    }
+
+    if( HWREG( uiGen + PWM_O_X_CTL ) & ( 1 << 18 ) ) g_SIM.bFault |= bInput;
+    else                                             g_SIM.bFault  = bInput;
+
+    // Sequence interrupt
+    if( bInt )
+    {
+        HWREG( ADC1_BASE + ADC_O_RIS ) |= ( 1 << 1 );
+
+        if( HWREG( ADC1_BASE + ADC_O_IM ) & ( 1 << 1 ) )
+        {
+            ADC1_SS1_IntHandler();
+            SIM_Acknowledge( ADC1_BASE, ADC_O_RIS, ADC_O_ISC );
+        }
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Edge( bool bRev, double dTime, int64_t iCount )
+// PURPOSE  : One encoder count, reaching iCount at dTime.
+//----------------------------------------------------------------------------
+
+static void SIM_Edge( bool bRev, double dTime, int64_t iCount )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ 0 ];
+    uint32_t uiQEI = pAxis->uiQEIBase;
+    uint32_t uiMax = HWREG( uiQEI + QEI_O_MAXPOS );
+    uint32_t uiPos = HWREG( uiQEI + QEI_O_POS );
+
+    if( g_SIM.bNoEncoder ) return;
+    if( g_SIM.bSwapped ) bRev = !bRev;
+
+    // Position counter (resets at MAXPOS)
+    if( !bRev ) uiPos = ( uiPos >= uiMax ) ? 0 : uiPos + 1;
+    else        uiPos = ( uiPos == 0 ) ? uiMax : uiPos - 1;
+    HWREG( uiQEI + QEI_O_POS ) = uiPos;
+
+    // Direction status and change
+    if( bRev != g_SIM.bLastRev )
+    {
+        g_SIM.bWinRev = true;
+        HWREG( uiQEI + QEI_O_RIS ) |= ( 1 << 2 );
+    }
+    g_SIM.bLastRev = bRev;
+    HWREG( uiQEI + QEI_O_STAT ) = ( uint32_t )( bRev ? !QEI_DIR_FWD : QEI_DIR_FWD ) << 1;
+
+    // Velocity accumulator (after the predivider)
+    uint32_t uiDiv = 1u << ( ( HWREG( uiQEI + QEI_O_CTL ) >> 6 ) & 7 );
+    if( ++g_SIM.uiDivAcc >= uiDiv )
+    {
+        g_SIM.uiDivAcc = 0;
+        g_SIM.uiWinEdges++;
+    }
+
+    // PhA rising edge: timestamp it (Wide Timer 0A capture)
+    if( ( iCount % QEI_EDGES ) == 0 )
+    {
+        HWREG( WTIMER0_BASE + TIMER_O_TAR ) = ( uint32_t )( uint64_t )( dTime * MT_CLOCK );
+        WTIMER0A_IntHandler();
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Plant( float fDuty, float fdt )
+// PURPOSE  : Advances the motor over one PWM period at a duty (signed).
+//----------------------------------------------------------------------------
+
+static void SIM_Plant( float fDuty, float fdt )
+{
+    float fW0 = g_SIM.fSpeed;
+    float fW1;
+    float fDrive = fDuty - g_SIM.fLoad;
+    float fBreak = ( g_SIM.fStiction > g_SIM.fFric ) ? g_SIM.fStiction : g_SIM.fFric;
+
+    // Load torque noise: white noise through a first order low-pass
+    if( g_SIM.fNoise > 0.0f )
+    {
+        g_SIM.fNoiseNow += ( fdt / SIM_NOISE_TC ) * ( -g_SIM.fNoiseNow )
+                         + ( g_SIM.fNoise * sqrtf( 2.0f * fdt / SIM_NOISE_TC ) * SIM_Random() );
+        fDrive -= g_SIM.fNoiseNow;
+    }
+
+    if( g_SIM.bJam )
+    {
+        fW1 = 0.0f;
+    }
+    else if( ( fW0 == 0.0f ) && ( fabsf( fDrive ) <= fBreak ) )
+    {
+        // Held by static friction
+        fW1 = 0.0f;
+    }
+    else
+    {
+        float fDir = ( fW0 != 0.0f ) ? ( fW0 > 0.0f ? 1.0f : -1.0f )
+                                     : ( fDrive > 0.0f ? 1.0f : -1.0f );
+        float fTarget = g_SIM.fKm * ( fDrive - ( fDir * g_SIM.fFric ) );
+
+        fW1 = fTarget + ( ( fW0 - fTarget ) * expf( -fdt / g_SIM.fTau ) );
+
+        // Friction stops the shaft rather than reversing it
+        if( ( g_SIM.fFric > 0.0f ) && ( fW1 * fDir < 0.0f ) ) fW1 = 0.0f;
+    }
+
+    // Position, and the counts crossed on the way
+    double dCPS = g_aAxis[ 0 ].pProfile->uiCountsPerRev / 60.0;
+    double dP0  = g_SIM.dPos;
+    double dP1  = dP0 + ( 0.5 * ( fW0 + fW1 ) * fdt * dCPS );
+    int64_t iTo = ( int64_t )floor( dP1 );
+
+    while( g_SIM.iCount != iTo )
+    {
+        bool    bRev   = iTo < g_SIM.iCount;
+        int64_t iEdge  = bRev ? g_SIM.iCount : g_SIM.iCount + 1;
+        double  dFrac  = ( iEdge - dP0 ) / ( dP1 - dP0 );
+
+        g_SIM.iCount += bRev ? -1 : 1;
+        SIM_Edge( bRev, g_SIM.dTime + ( dFrac * fdt ), g_SIM.iCount );
+    }
+
+    g_SIM.dPos    = dP1;
+    g_SIM.fSpeed  = fW1;
+    g_SIM.dTime  += fdt;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Init( void )
+// PURPOSE  : Starts a simulation: registers cleared, the control modules
+//            initialized as Initialize does, the motor at rest with the
+//            firmware's model and no load.
+//----------------------------------------------------------------------------
+
+void SIM_Init( void )
+{
+    uint8_t i;
+
+    HOST_Reset();
+
+    g_SIM.fKm    = OBSERVER_KM;
+    g_SIM.fTau   = OBSERVER_TAU;
+    g_SIM.fFric  = 0.0f;
+    g_SIM.fStiction = 0.0f;
+    g_SIM.fLoad  = 0.0f;
+    g_SIM.fNoise = 0.0f;
+    g_SIM.bCoast = false;
+
+    g_SIM.bJam       = false;
+    g_SIM.bNoEncoder = false;
+    g_SIM.bSwapped   = false;
+    g_SIM.fShort     = 0.0f;
+
+    g_SIM.dTime   = 0.0;
+    g_SIM.dPos    = 0.0;
+    g_SIM.fSpeed  = 0.0f;
+    g_SIM.fDuty   = 0.0f;
+    g_SIM.fNoiseNow = 0.0f;
+    g_SIM.fCurrent  = 0.0f;
+    g_SIM.uiTicks = 0;
+    g_SIM.dIsrTime = 0.0;
+
+    g_SIM.iCount     = 0;
+    g_SIM.uiWinEdges = 0;
+    g_SIM.uiWinTicks = 0;
+    g_SIM.uiDivAcc   = 0;
+    g_SIM.bLastRev   = false;
+    g_SIM.bWinRev    = false;
+
+    g_SIM.uiSample = 0;
+    g_SIM.bFault   = false;
+
+    HOST_FifoInit( ADC1_BASE + ADC_O_SSFIFO1, ADC1_BASE + ADC_O_SSFSTAT1, ( 1 << 8 ) );
+
+    g_uiSeed = 0x12345678;
+
+    for( i = 0; i < MOTOR_NUM_AXES; i++ )
+    {
+        MOTOR_Init( &g_aMCP[ i ], i );
+        OBSERVER_Init( &g_aOBS[ i ], i == MT_AXIS ? MOTOR_CONTROL_DT
+                                                  : QEI_GetWindow( g_aMCP[ i ].pAxis ) );
+        QEI_Init( g_aMCP[ i ].pAxis );
+        POSITION_Init( &g_aPOS[ i ], i );
+        FAULT_Init( &g_aFLT[ i ] );
+        THERMAL_Init( &g_aTHM[ i ], THERMAL_DT );
+        ILC_Init( &g_aILC[ i ] );
+        STEP_Init( &g_aSTEP[ i ], STEP_BAND );
+        FRIC_Init( &g_aFRIC[ i ], &g_aMCP[ i ] );
+    }
+    MT_Init( &g_MT, g_aMCP[ MT_AXIS ].pAxis );
+    MPC_Init( &g_MPC, MPC_STEP );
+    CURRENT_Init( &g_CUR, g_aMCP[ CURRENT_AXIS ].pAxis, MOTOR_CONTROL_DT );
+    SEQ_Init( &g_SEQ, MOTOR_CONTROL_DT );
+    TRACE_Init( MOTOR_CONTROL_DT );
+
+    TIMER_Init( g_MCP.fdt );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Tick( void )
+// PURPOSE  : Runs one control interval.
+//----------------------------------------------------------------------------
+
+void SIM_Tick( void )
+{
+    const MOTOR_AXIS *pAxis = &g_aAxis[ 0 ];
+    uint32_t uiGen = pAxis->uiPWMBase + pAxis->uiPWMGen;
+    uint32_t uiQEI = pAxis->uiQEIBase;
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+    uint32_t uiFltStat = pAxis->uiPWMBase + PWM_O_0_FLTSTAT1 + ( uiGenNum * PWM_O_FLTSTAT_STEP );
+    float fdt = MOTOR_CONTROL_DT / SIM_SUBSTEPS;
+    float fSum = 0.0f;
+    uint8_t i, k;
+
+    for( i = 0; i < SIM_SUBSTEPS; i++ )
+    {
+        // Generator interrupt (counter = LOAD, if enabled), then the period
+        // it set up
+        if( HWREG( uiGen + PWM_O_X_INTEN ) & ( 1 << 1 ) ) PWM0_GEN0_IntHandler();
+
+        // Latched fault released (CURRENT_Clear), comparators reset
+        if( HWREG( uiFltStat ) & 1 ) g_SIM.bFault = false;
+        HWREG( uiFltStat ) = 0;
+        HWREG( ADC1_BASE + ADC_O_DCRIC ) = 0;
+
+        // Duty: the drive over the segments between the counter events
+        uint32_t uiLoad = HWREG( uiGen + PWM_O_X_LOAD );
+        uint32_t uiCmpA = HWREG( uiGen + PWM_O_X_CMPA );
+        uint32_t uiCmpB = HWREG( uiGen + PWM_O_X_CMPB );
+        uint32_t auEdge[ 7 ] = { 0, uiCmpA, uiCmpB, uiLoad, ( 2 * uiLoad ) - uiCmpB,
+                                 ( 2 * uiLoad ) - uiCmpA, 2 * uiLoad };
+        int32_t  iOn = 0;
+
+        for( k = 1; k < 7; k++ )
+        {
+            uint32_t uiEdge = auEdge[ k ];
+            uint8_t  j;
+
+            for( j = k; ( j > 0 ) && ( auEdge[ j - 1 ] > uiEdge ); j-- ) auEdge[ j ] = auEdge[ j - 1 ];
+            auEdge[ j ] = uiEdge;
+        }
+
+        for( k = 0; k < 6; k++ )
+        {
+            if( auEdge[ k + 1 ] > auEdge[ k ] )
+            {
+                iOn += SIM_Drive( auEdge[ k ] ) * ( int32_t )( auEdge[ k + 1 ] - auEdge[ k ] );
+            }
+        }
+
+        float fDuty = uiLoad ? ( float )iOn / ( 2 * uiLoad ) : 0.0f;
+
+        // Coasting: the terminals float at the back EMF
+        if( g_SIM.bCoast ) fDuty = g_SIM.fSpeed / g_SIM.fKm;
+
+        fSum += fDuty;
+        SIM_Plant( fDuty, fdt );
+
+        g_SIM.fCurrent = SIM_STALL_AMPS * ( fDuty - ( g_SIM.fSpeed / g_SIM.fKm ) );
+        SIM_Sense();
+    }
+    g_SIM.fDuty = fSum / SIM_SUBSTEPS;
+
+    // Velocity window complete
+    uint32_t uiWindow = ( uint32_t )( ( ( HWREG( uiQEI + QEI_O_LOAD ) + 1.0f ) / 80000000.0f
+                                      / MOTOR_CONTROL_DT ) + 0.5f );
+
+    if( ++g_SIM.uiWinTicks >= uiWindow )
+    {
+        HWREG( uiQEI + QEI_O_SPEED ) = g_SIM.uiWinEdges;
+        HWREG( uiQEI + QEI_O_RIS ) |= ( 1 << 1 );
+
+        g_SIM.uiWinTicks = 0;
+        g_SIM.uiWinEdges = 0;
+        g_SIM.bWinRev    = false;
+
+        QEI0_IntHandler();
+        SIM_Acknowledge( uiQEI, QEI_O_RIS, QEI_O_ISC );
+    }
+
+    // Control interval
+    HWREG( WTIMER0_BASE + TIMER_O_TAV ) = ( uint32_t )( uint64_t )( g_SIM.dTime * MT_CLOCK );
+
+    struct timespec sStart, sEnd;
+
+    clock_gettime( CLOCK_MONOTONIC, &sStart );
+    TIMER0A_IntHandler();
+    clock_gettime( CLOCK_MONOTONIC, &sEnd );
+
+    g_SIM.dIsrTime += ( sEnd.tv_sec - sStart.tv_sec ) + ( ( sEnd.tv_nsec - sStart.tv_nsec ) * 1e-9 );
+
+    SIM_Acknowledge( uiQEI, QEI_O_RIS, QEI_O_ISC );
+
+    g_SIM.uiTicks++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SIM_Run( float fSeconds )
+// PURPOSE  : Runs for a time (whole control intervals).
+//----------------------------------------------------------------------------
+
+void SIM_Run( float fSeconds )
+{
+    uint32_t n = ( uint32_t )( ( fSeconds / MOTOR_CONTROL_DT ) + 0.5f );
+
+    while( n-- ) SIM_Tick();
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END SIM.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : SIM.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef SIM_H_
+#define SIM_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define SIM_SUBSTEPS    20      // Plant steps per control interval (one per PWM period)
+#define SIM_NOISE_TC    0.02f   // Load torque noise correlation time (s)
+#define SIM_STALL_AMPS  1.5f    // Winding current at 100 % duty, shaft held (A)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagSIM_PLANT
+{
+    // Motor (axis 0), output shaft; SIM_Init sets the firmware's model
+    float fKm;          // RPM at 100 % duty (no load)
+    float fTau;         // Mechanical time constant (s)
+    float fFric;        // Coulomb friction (duty)
+    float fStiction;    // Breakaway friction at rest (duty, if above fFric)
+    float fLoad;        // Load torque (duty, opposing bDir = 1)
+    float fNoise;       // Load torque noise (duty RMS, low-pass, SIM_NOISE_TC)
+    bool  bCoast;       // Bridge off (all four switches open), no drive or current
+
+    // Faults
+    bool bJam;          // Shaft locked
+    bool bNoEncoder;    // Encoder wire broken (no edges)
+    bool bSwapped;      // Encoder phases swapped (counting against the shaft)
+    float fShort;       // Extra shunt current while a high side is on (A)
+
+    // State
+    double dTime;       // Simulated time (s)
+    double dPos;        // Position (counts, + in the bDir = 1 direction)
+    float  fSpeed;      // Output shaft speed (RPM, + in the bDir = 1 direction)
+    float  fDuty;       // Duty applied over the last interval (signed)
+    float  fNoiseNow;   // Load torque noise (duty)
+    float  fCurrent;    // Winding current (A, + in the bDir = 1 direction)
+    uint32_t uiTicks;   // Control intervals run
+    double dIsrTime;    // Host time spent in the control interrupt (s)
+
+    // QEI0 and M/T capture emulation
+    int64_t  iCount;    // Encoder count (whole counts of dPos)
+    uint32_t uiWinEdges;    // Edges in the current velocity window
+    uint32_t uiWinTicks;    // Control intervals into the current window
+    uint32_t uiDivAcc;      // Predivider remainder (edges)
+    bool     bLastRev;      // Last edge was in the bDir = 0 direction
+    bool     bWinRev;       // Direction changed within the window
+
+    // Current sense (ADC1 SS1, digital comparators) and PWM fault emulation
+    uint32_t uiSample;      // Last current sample (ADC counts)
+    bool     bFault;        // Fault latched in the generator of axis 0
+
+} SIM_PLANT;
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern SIM_PLANT g_SIM;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void  SIM_Init( void );
+void  SIM_Tick( void );
+void  SIM_Run( float fSeconds );
+float SIM_Random( void );
+int8_t  SIM_Drive( uint32_t uiTime );
+int32_t SIM_Trigger( void );
+
+#endif // SIM_H_
+
+//----------------------------------------------------------------------------
+// END SIM.H
+//----------------------------------------------------------------------------
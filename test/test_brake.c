@@ -0,0 +1,130 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_BRAKE.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Active braking (MOTOR_Brake) on the plant simulation with friction.
+//
+// Built twice: test_brake with the deceleration loop and
+// test_brake_nobrake with MOTOR_NO_BRAKE (the speed controller alone).
+// Axis 0 runs at BRAKE_SPEED, then the setpoint drops to zero, and the
+// time until the shaft is below BRAKE_STOPPED and the peak winding current
+// are measured:
+//
+//     Coast     the bridge turned off at the drop (no drive, no current)
+//     Control   the firmware's stop
+//
+// Both stops are faster than coasting: at zero duty the bridge shorts the
+// motor (see MOTOR_Brake), so the controller alone brakes it too, with up
+// to the full short current (the stall current at the back EMF). With the
+// deceleration loop the stop must take no longer than the profile
+// (BRAKE_SPEED at MOTOR_BRAKE_DECEL) plus BRAKE_MARGIN, and the current
+// stay under BRAKE_PEAK of the full short; without it the current goes
+// above that.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#ifdef MOTOR_USE_BRAKE
+#define BRAKE_NAME      "Brake loop"
+#else
+#define BRAKE_NAME      "PID alone "
+#endif
+
+#define BRAKE_SPEED     120.0f  // Speed before the stop (RPM)
+#define BRAKE_FRIC      0.05f   // Coulomb friction (duty)
+#define BRAKE_SETTLE    2.0f    // Time at the speed before the stop (s)
+#define BRAKE_STOPPED   1.0f    // Stopped below this speed (RPM)
+#define BRAKE_LIMIT     10.0f   // Longest wait (s)
+#define BRAKE_MARGIN    0.1f    // Stop beyond the profile (s)
+#define BRAKE_PEAK      0.5f    // Braking current bound (of the full short)
+#define BRAKE_NONE      0.001f  // No current (A)
+
+//----------------------------------------------------------------------------
+// FUNCTION : BRAKE_Stop( bool bCoast, float *pPeak )
+// PURPOSE  : Returns the time from the setpoint drop until the shaft is
+//            stopped (s, -1 if it is not), with the peak winding current (A).
+//----------------------------------------------------------------------------
+
+static float BRAKE_Stop( bool bCoast, float *pPeak )
+{
+    uint32_t i;
+
+    SIM_Init();
+    g_SIM.fFric = BRAKE_FRIC;
+
+    MOTOR_SetSetpoint( &g_MCP, BRAKE_SPEED );
+    SIM_Run( BRAKE_SETTLE );
+
+    MOTOR_SetSetpoint( &g_MCP, 0.0f );
+    g_SIM.bCoast = bCoast;
+
+    *pPeak = 0.0f;
+
+    for( i = 1; i <= ( uint32_t )( BRAKE_LIMIT / MOTOR_CONTROL_DT ); i++ )
+    {
+        SIM_Tick();
+
+        if( fabsf( g_SIM.fCurrent ) > *pPeak ) *pPeak = fabsf( g_SIM.fCurrent );
+        if( fabsf( g_SIM.fSpeed ) < BRAKE_STOPPED ) return i * MOTOR_CONTROL_DT;
+    }
+
+    return -1.0f;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    float fCoastPeak, fPeak;
+    float fCoast = BRAKE_Stop( true, &fCoastPeak );
+    float fStop  = BRAKE_Stop( false, &fPeak );
+
+    printf( "Stop from %.0f RPM      Time     Peak current\n", BRAKE_SPEED );
+    printf( "Coast                %6.3f s   %.3f A\n", fCoast, fCoastPeak );
+    printf( "%s           %6.3f s   %.3f A\n", BRAKE_NAME, fStop, fPeak );
+
+    float fShort = SIM_STALL_AMPS * BRAKE_SPEED / g_SIM.fKm;
+
+    HOST_CHECK( fCoast > 0.0f );
+    HOST_CHECK( fCoastPeak < BRAKE_NONE );
+    HOST_CHECK( ( fStop > 0.0f ) && ( fStop < fCoast ) );
+
+#ifdef MOTOR_USE_BRAKE
+    HOST_CHECK( fStop < ( BRAKE_SPEED / MOTOR_BRAKE_DECEL ) + BRAKE_MARGIN );
+    HOST_CHECK( fPeak < BRAKE_PEAK * fShort );
+#else
+    HOST_CHECK( fPeak > BRAKE_PEAK * fShort );
+#endif
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_BRAKE.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,285 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_CONTROL.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Speed controller benchmark on the plant simulation.
+//
+// Built three times: test_control_pid with the PID, test_control_pid_noff
+// with the PID and MOTOR_NO_LOAD_FF (no load torque feed-forward), and
+// test_control_mpc with MOTOR_USE_MPC (see timer.c), so all run the same
+// plant and cases. The
+// plant has Coulomb friction; the profile adds load torque noise, which
+// the steps and the load step leave out so the settling bands mean
+// something:
+//
+//     Steps     setpoint steps, figures from the step analyser (step.c),
+//               and the largest duty applied, which must stay within the
+//               bootstrap limit (the last step saturates the duty)
+//     Profile   a repeated conveyor cycle (ramp up, hold, ramp down,
+//               stop), RMS error against the setpoint
+//     Load      a load step at constant speed, the largest dip and the
+//               time back within 2 RPM; the PID must be back within
+//               CONTROL_FF_BACK with the feed-forward and not without it
+//
+// The cost is host time per controller call (the lowest of
+// CONTROL_CPU_REPEAT runs), not Cortex-M4 cycles.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "host.h"
+#include "sim.h"
+#include "mpc.h"
+#include "step.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#ifdef MOTOR_USE_MPC
+#define CONTROL_LAW     "MPC"
+#else
+#define CONTROL_LAW     "PID"
+#endif
+
+#ifdef MOTOR_USE_LOAD_FF
+#define CONTROL_NAME    CONTROL_LAW
+#else
+#define CONTROL_NAME    CONTROL_LAW " (no load FF)"
+#endif
+
+#define CONTROL_NOISE   0.02f   // Load torque noise (duty RMS)
+#define CONTROL_FRIC    0.03f   // Coulomb friction (duty)
+#define CONTROL_FF_BACK 0.25f   // PID load step recovery with the feed-forward (s)
+
+// Conveyor cycle (s, RPM)
+#define PROFILE_RAMP    0.3f
+#define PROFILE_HOLD    0.5f
+#define PROFILE_STOP    0.4f
+#define PROFILE_RPM     120.0f
+#define PROFILE_CYCLES  5
+
+#define CONTROL_CPU_CALLS 2000000   // Controller calls timed per run
+#define CONTROL_CPU_REPEAT 5        // Runs timed (the lowest is reported)
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern STEP_PARAMS g_aSTEP[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : CONTROL_Start( float fNoise )
+// PURPOSE  : Starts a simulation with the common plant.
+//----------------------------------------------------------------------------
+
+static void CONTROL_Start( float fNoise )
+{
+    SIM_Init();
+
+    g_SIM.fNoise = fNoise;
+    g_SIM.fFric  = CONTROL_FRIC;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CONTROL_Step( float fFrom, float fTo )
+// PURPOSE  : Runs and reports a setpoint step.
+//----------------------------------------------------------------------------
+
+static void CONTROL_Step( float fFrom, float fTo )
+{
+    float fMax = 0.0f;
+    uint32_t i;
+
+    CONTROL_Start( 0.0f );
+
+    MOTOR_SetSetpoint( &g_MCP, fFrom );
+    SIM_Run( 3.0f );
+
+    uint32_t uiCount = g_aSTEP[ 0 ].uiCount;
+
+    MOTOR_SetSetpoint( &g_MCP, fTo );
+    for( i = 0; i < ( uint32_t )( ( STEP_WINDOW + 0.1f ) / MOTOR_CONTROL_DT ); i++ )
+    {
+        SIM_Tick();
+        if( fabsf( g_SIM.fDuty ) > fMax ) fMax = fabsf( g_SIM.fDuty );
+    }
+
+    const STEP_RESULT *pRes = &g_aSTEP[ 0 ].asResult[ ( g_aSTEP[ 0 ].uiHead + STEP_HIST - 1 ) % STEP_HIST ];
+
+    HOST_CHECK( g_aSTEP[ 0 ].uiCount > uiCount );
+    HOST_CHECK( pRes->fSettle >= 0.0f );
+    HOST_CHECK( fMax <= MOTOR_DUTY_MAX + 0.001f );
+
+    printf( "%s step %5.1f -> %5.1f RPM: tr %5.3f s  OS %4.1f %%  ts %5.3f s  IAE %5.2f  duty %5.3f\n",
+            CONTROL_NAME, fFrom, fTo, pRes->fRise, pRes->fOvershoot, pRes->fSettle, pRes->fIAE, fMax );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CONTROL_Profile( void )
+// PURPOSE  : Runs and reports the conveyor cycle.
+//----------------------------------------------------------------------------
+
+static void CONTROL_Profile( void )
+{
+    float fPeriod = ( 2.0f * PROFILE_RAMP ) + PROFILE_HOLD + PROFILE_STOP;
+    uint32_t uiTicks = ( uint32_t )( ( PROFILE_CYCLES * fPeriod / MOTOR_CONTROL_DT ) + 0.5f );
+    double dSum = 0.0;
+    uint32_t i;
+
+    CONTROL_Start( CONTROL_NOISE );
+
+    for( i = 0; i < uiTicks; i++ )
+    {
+        float t = fmodf( i * MOTOR_CONTROL_DT, fPeriod );
+        float fSP;
+
+        if( t < PROFILE_RAMP )                          fSP = PROFILE_RPM * t / PROFILE_RAMP;
+        else if( t < PROFILE_RAMP + PROFILE_HOLD )      fSP = PROFILE_RPM;
+        else if( t < ( 2.0f * PROFILE_RAMP ) + PROFILE_HOLD )
+        {
+            fSP = PROFILE_RPM * ( 1.0f - ( ( t - PROFILE_RAMP - PROFILE_HOLD ) / PROFILE_RAMP ) );
+        }
+        else                                            fSP = 0.0f;
+
+        // Main loop publish, picked up on this tick
+        MOTOR_SetSetpoint( &g_MCP, fSP );
+        SIM_Tick();
+
+        // Skip the first cycle (start up)
+        if( i * MOTOR_CONTROL_DT < fPeriod ) continue;
+
+        dSum += ( g_SIM.fSpeed - fSP ) * ( g_SIM.fSpeed - fSP );
+    }
+
+    float fRms = sqrt( dSum / ( uiTicks - ( uint32_t )( fPeriod / MOTOR_CONTROL_DT ) ) );
+
+    printf( "%s profile: RMS error %5.2f RPM\n", CONTROL_NAME, fRms );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CONTROL_Load( float fSP, float fLoad )
+// PURPOSE  : Runs and reports a load step.
+//----------------------------------------------------------------------------
+
+static void CONTROL_Load( float fSP, float fLoad )
+{
+    float fDip = 0.0f;
+    float fBack = -1.0f;
+    uint32_t i;
+
+    CONTROL_Start( 0.0f );
+
+    MOTOR_SetSetpoint( &g_MCP, fSP );
+    SIM_Run( 3.0f );
+
+    g_SIM.fLoad = fLoad;
+
+    for( i = 0; i < 3000; i++ )
+    {
+        SIM_Tick();
+
+        float fErr = fSP - g_SIM.fSpeed;
+
+        if( fErr > fDip ) fDip = fErr;
+        if( fabsf( fErr ) > 2.0f ) fBack = -1.0f;
+        else if( fBack < 0.0f )    fBack = i * MOTOR_CONTROL_DT;
+    }
+
+    printf( "%s load step %4.2f at %5.1f RPM: dip %5.2f RPM, back within 2 RPM after %5.3f s\n",
+            CONTROL_NAME, fLoad, fSP, fDip, fBack );
+
+    HOST_CHECK( fBack >= 0.0f );
+
+#ifndef MOTOR_USE_MPC
+#ifdef MOTOR_USE_LOAD_FF
+    HOST_CHECK( fBack < CONTROL_FF_BACK );
+#else
+    HOST_CHECK( fBack > CONTROL_FF_BACK );
+#endif
+#endif
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CONTROL_Cost( void )
+// PURPOSE  : Times the controller (host).
+//----------------------------------------------------------------------------
+
+static void CONTROL_Cost( void )
+{
+    struct timespec sStart, sEnd;
+    uint32_t i, n;
+    double dBest = 0.0;
+
+    CONTROL_Start( 0.0f );
+    g_MCP.fSP = 60.0f;
+
+    // The host is shared, so the quietest run is the cost
+    for( n = 0; n < CONTROL_CPU_REPEAT; n++ )
+    {
+        clock_gettime( CLOCK_MONOTONIC, &sStart );
+        for( i = 0; i < CONTROL_CPU_CALLS; i++ )
+        {
+#ifdef MOTOR_USE_MPC
+            MPC_Control( &g_MCP );
+#else
+            MOTOR_PID( &g_MCP );
+#endif
+        }
+        clock_gettime( CLOCK_MONOTONIC, &sEnd );
+
+        double dNs = ( ( sEnd.tv_sec - sStart.tv_sec ) * 1e9 ) + ( sEnd.tv_nsec - sStart.tv_nsec );
+        if( ( n == 0 ) || ( dNs < dBest ) ) dBest = dNs;
+    }
+
+    printf( "%s host cost %.1f ns per call\n", CONTROL_NAME, dBest / CONTROL_CPU_CALLS );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    CONTROL_Step( 0.0f, 60.0f );
+    CONTROL_Step( 60.0f, 120.0f );
+    CONTROL_Step( 120.0f, 60.0f );
+    CONTROL_Step( 60.0f, 180.0f );
+    CONTROL_Profile();
+    CONTROL_Load( 80.0f, 0.15f );
+    CONTROL_Cost();
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_CONTROL.C
+//----------------------------------------------------------------------------
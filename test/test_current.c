@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_CURRENT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Current sense and hardware overcurrent trip (current.c) on the plant
+// simulation, through the registers CURRENT_Init programs (ADC1 SS1, digital
+// comparator 0, the generator's fault source, PWMFAULT and PWMFAULTVAL).
+//
+// Axis 0 runs at a steady speed against a load, then a short is injected
+// that puts the shunt current above CURRENT_TRIP while a high side is on:
+//
+//     Sense      the control loop's current matches the winding current
+//     Hardware   with the PWM fault interrupt masked, the outputs are
+//                forced to the fault value (both high, so both low sides
+//                on and no drive) from the PWM period after the sample,
+//                while the generator still has the running duty and the
+//                software knows nothing
+//     Record     with the interrupt, the trip record is filled and the
+//                control loop latches the axis fault on its next interval
+//     Release    with the short gone, CURRENT_Clear and FAULT_Clear let the
+//                axis drive again
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+#include "current.h"
+#include "fault.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define CUR_SPEED       60.0f   // Steady speed (RPM)
+#define CUR_LOAD        0.2f    // Load torque (duty)
+#define CUR_SHORT       3.5f    // Injected short (A)
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern CURRENT_PARAMS g_CUR;
+extern FAULT_PARAMS g_aFLT[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : CUR_Start( void )
+// PURPOSE  : Starts a simulation at a steady speed against the load.
+//----------------------------------------------------------------------------
+
+static void CUR_Start( void )
+{
+    SIM_Init();
+
+    g_SIM.fLoad = CUR_LOAD;
+    MOTOR_SetSetpoint( &g_MCP, CUR_SPEED );
+    SIM_Run( 3.0f );
+
+    HOST_CHECK( !g_SIM.bFault && !g_CUR.bHWTrip && !g_aFLT[ 0 ].bLatched );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CUR_Forced( void )
+// PURPOSE  : Returns true if no high side is on at any time of the PWM
+//            period.
+//----------------------------------------------------------------------------
+
+static bool CUR_Forced( void )
+{
+    uint32_t uiLoad = HWREG( g_MCP.pAxis->uiPWMBase + g_MCP.pAxis->uiPWMGen + PWM_O_X_LOAD );
+    uint32_t t;
+
+    for( t = 0; t < 2 * uiLoad; t++ )
+    {
+        if( SIM_Drive( t ) != 0 ) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    const MOTOR_AXIS *pAxis;
+    uint32_t uiTrip = ( uint32_t )( CURRENT_TRIP / CURRENT_AMPS_PER_COUNT );
+
+    // Sense: the mean of the samples of an interval
+    CUR_Start();
+    pAxis = g_MCP.pAxis;
+
+    printf( "Sense     %.3f A measured, %.3f A winding, sample %lu of trip %lu\n",
+            g_CUR.fCurrent, g_SIM.fCurrent,
+            ( unsigned long )g_SIM.uiSample, ( unsigned long )uiTrip );
+
+    HOST_CHECK( fabsf( g_CUR.fCurrent - g_SIM.fCurrent ) < 0.02f );
+    HOST_CHECK( g_CUR.fCurrent > 0.1f );
+
+    // Hardware: the fault interrupt masked, so only the PWM acts
+    uint32_t uiGenNum = ( pAxis->uiPWMGen - PWM_O_0_CTL ) / ( PWM_O_1_CTL - PWM_O_0_CTL );
+    float fDuty = g_SIM.fDuty;
+
+    HWREG( pAxis->uiPWMBase + PWM_O_INTEN ) &= ~( 1 << ( 16 + uiGenNum ) );
+    g_SIM.fShort = CUR_SHORT;
+    SIM_Tick();
+
+    printf( "Hardware  duty %.3f before, %.3f over the interval\n", fDuty, g_SIM.fDuty );
+
+    HOST_CHECK( g_SIM.bFault );
+    HOST_CHECK( CUR_Forced() );
+    HOST_CHECK( ( HWREG( pAxis->uiPWMBase + PWM_O_FAULT ) & pAxis->uiPWMEnable ) == pAxis->uiPWMEnable );
+    HOST_CHECK( ( HWREG( pAxis->uiPWMBase + PWM_O_FAULTVAL ) & pAxis->uiPWMEnable ) == pAxis->uiPWMEnable );
+
+    // Only the first PWM period (before the first sample) drove
+    HOST_CHECK( fabsf( g_SIM.fDuty - ( fDuty / SIM_SUBSTEPS ) ) < 0.01f );
+
+    // Generator still running the duty, software unaware
+    HOST_CHECK( HWREG( pAxis->uiPWMBase + pAxis->uiPWMGen + PWM_O_X_CMPA ) > 0 );
+    HOST_CHECK( !g_CUR.bHWTrip && ( g_CUR.uiTrips == 0 ) && !g_aFLT[ 0 ].bLatched );
+
+    // Record: the fault interrupt fills the trip record
+    CUR_Start();
+    g_SIM.fShort = CUR_SHORT;
+    uint32_t uiTick = g_CUR.uiTicks;
+    float fBefore = g_CUR.fCurrent;
+    SIM_Tick();
+
+    printf( "Record    cause 0x%02x, tick %lu, %.3f A, I2t %.3f, %lu trip(s)\n",
+            g_CUR.sTrip.uiCause, ( unsigned long )g_CUR.sTrip.uiTick,
+            g_CUR.sTrip.fCurrent, g_CUR.sTrip.fI2t, ( unsigned long )g_CUR.uiTrips );
+
+    HOST_CHECK( g_SIM.bFault && CUR_Forced() );
+    HOST_CHECK( g_CUR.bHWTrip );
+    HOST_CHECK( g_CUR.uiTrips == 1 );
+    HOST_CHECK( g_CUR.sTrip.uiCause == FAULT_OVERCURRENT );
+    HOST_CHECK( g_CUR.sTrip.uiTick == uiTick );
+    HOST_CHECK( g_CUR.sTrip.fCurrent == fBefore );
+
+    // The control interval that ran after it latched the axis fault
+    HOST_CHECK( g_aFLT[ 0 ].bLatched && ( g_aFLT[ 0 ].uiCause & FAULT_OVERCURRENT ) );
+
+    // Release: the short gone, the trip cleared
+    g_SIM.fShort = 0.0f;
+    SIM_Run( 0.1f );
+    HOST_CHECK( g_SIM.bFault );
+
+    CURRENT_Clear( &g_CUR );
+    FAULT_Clear( &g_aFLT[ 0 ], &g_MCP );
+    SIM_Run( 3.0f );
+
+    printf( "Release   %.1f RPM, %lu trip(s)\n", g_SIM.fSpeed, ( unsigned long )g_CUR.uiTrips );
+
+    HOST_CHECK( !g_SIM.bFault && !g_CUR.bHWTrip && !g_aFLT[ 0 ].bLatched );
+    HOST_CHECK( fabsf( g_SIM.fSpeed - CUR_SPEED ) < 2.0f );
+    HOST_CHECK( g_CUR.uiTrips == 1 );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_CURRENT.C
+//----------------------------------------------------------------------------
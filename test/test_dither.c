@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_DITHER.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Pulse width dithering (MOTOR_Dither) on the plant simulation.
+//
+// Built twice: test_dither with the dither and test_dither_nodither with
+// MOTOR_NO_DITHER, so both run the same cases. Axis 0 holds steady speeds
+// under the speed loop, without load noise, and the shaft speed is measured:
+//
+//     Ripple    RMS of the speed about its mean, which without the dither
+//               is the loop hunting between two whole counts of CMPA; with
+//               it, under DITHER_RIPPLE at every speed
+//     Error     mean speed less the setpoint
+//
+// With the dither the generator interrupt must be enabled at
+// MOTOR_DITHER_PRI, below the control interrupt (Timer 0A), so it cannot
+// delay the 1 kHz loop.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#ifdef MOTOR_USE_DITHER
+#define DITHER_NAME     "Dither on "
+#else
+#define DITHER_NAME     "Dither off"
+#endif
+
+#define DITHER_SETTLE   3.0f    // Time at a speed before measuring (s)
+#define DITHER_MEASURE  3.0f    // Steady time measured (s)
+#define DITHER_RIPPLE   0.005f  // Largest ripple with the dither (RPM RMS)
+#define DITHER_TIMER0A  19      // Timer 0A interrupt number
+
+#ifdef MOTOR_USE_DITHER
+//----------------------------------------------------------------------------
+// FUNCTION : DITHER_Priority( uint32_t uiIrq )
+// PURPOSE  : Returns an interrupt's priority as programmed in the NVIC.
+//----------------------------------------------------------------------------
+
+static uint32_t DITHER_Priority( uint32_t uiIrq )
+{
+    return ( HWREG( NVIC_PRI0 + ( uiIrq & ~3 ) ) >> ( ( 8 * ( uiIrq & 3 ) ) + 5 ) ) & 0x07;
+}
+#endif
+
+//----------------------------------------------------------------------------
+// FUNCTION : DITHER_Case( float fSP, float *pRipple, float *pError )
+// PURPOSE  : Measures the speed ripple and error at a setpoint (RPM).
+//----------------------------------------------------------------------------
+
+static void DITHER_Case( float fSP, float *pRipple, float *pError )
+{
+    double dSum = 0.0, dSq = 0.0;
+    uint32_t uiTicks = ( uint32_t )( DITHER_MEASURE / MOTOR_CONTROL_DT );
+    uint32_t i;
+
+    SIM_Init();
+    MOTOR_SetSetpoint( &g_MCP, fSP );
+    SIM_Run( DITHER_SETTLE );
+
+    for( i = 0; i < uiTicks; i++ )
+    {
+        SIM_Tick();
+
+        dSum += g_SIM.fSpeed;
+        dSq  += g_SIM.fSpeed * g_SIM.fSpeed;
+    }
+
+    double dMean = dSum / uiTicks;
+    double dVar  = ( dSq / uiTicks ) - ( dMean * dMean );
+
+    *pRipple = ( dVar > 0.0 ) ? sqrt( dVar ) : 0.0f;
+    *pError  = dMean - fSP;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    static const float afSP[] = { 10.3f, 30.7f, 60.1f, 110.9f };
+    uint32_t i;
+
+    printf( "%s  speed ripple (RPM RMS) and mean error (RPM)\n", DITHER_NAME );
+
+    for( i = 0; i < sizeof( afSP ) / sizeof( afSP[ 0 ] ); i++ )
+    {
+        float fRipple, fError;
+
+        DITHER_Case( afSP[ i ], &fRipple, &fError );
+
+        printf( "%s %6.1f RPM  %.4f  %+.4f\n", DITHER_NAME, afSP[ i ], fRipple, fError );
+
+#ifdef MOTOR_USE_DITHER
+        HOST_CHECK( fRipple < DITHER_RIPPLE );
+#endif
+    }
+
+    // The generator interrupt, if enabled, below the control interrupt
+    const MOTOR_AXIS *pAxis = g_MCP.pAxis;
+    uint32_t uiGen = pAxis->uiPWMBase + pAxis->uiPWMGen;
+
+#ifdef MOTOR_USE_DITHER
+    HOST_CHECK( HWREG( uiGen + PWM_O_X_INTEN ) & ( 1 << 1 ) );
+    HOST_CHECK( DITHER_Priority( pAxis->uiPWMIrq ) > DITHER_Priority( DITHER_TIMER0A ) );
+#else
+    HOST_CHECK( !( HWREG( uiGen + PWM_O_X_INTEN ) & ( 1 << 1 ) ) );
+#endif
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_DITHER.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,262 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_FAULT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Fault supervisor (fault.c) on the plant simulation.
+//
+// Latency: each fault is injected at a steady speed and timed to the trip,
+// which must carry the expected cause and leave zero duty on the H-bridge
+// from the next PWM period:
+//
+//     Jam          shaft locked
+//     Encoder      wire broken (no more edges)
+//     Swapped      phases swapped (counting against the shaft)
+//     Phase error  the QEI phase error flag
+//
+// False positives: normal operation that must never trip, with load
+// torque noise throughout (the default recipe with its reversals, load
+// steps, starts against high friction, slow running with heavy noise).
+// The longest run of the stall and direction tests shows the margin left
+// to FAULT_STALL_TIME and FAULT_DIR_TIME.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include "host.h"
+#include "sim.h"
+#include "fault.h"
+#include "seq.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define FLT_NOISE       0.02f   // Load torque noise (duty RMS)
+#define FLT_FRIC        0.03f   // Coulomb friction (duty)
+#define FLT_LIMIT       5.0f    // Longest wait for a trip (s)
+
+enum
+{
+    FLT_JAM,
+    FLT_ENCODER,
+    FLT_SWAPPED,
+    FLT_PHASE,
+    FLT_NUM
+};
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern FAULT_PARAMS g_aFLT[ MOTOR_NUM_AXES ];
+extern SEQ_PARAMS g_SEQ;
+
+static const char *g_asName[ FLT_NUM ] = { "Jam", "Encoder", "Swapped", "Phase error" };
+static const uint8_t g_auCause[ FLT_NUM ] = { FAULT_STALL, FAULT_STALL, FAULT_DIRECTION, FAULT_ENCODER };
+static const float g_afSpeed[] = { 20.0f, 60.0f, 120.0f };
+
+#define FLT_SPEEDS      ( sizeof( g_afSpeed ) / sizeof( g_afSpeed[ 0 ] ) )
+
+static double g_dNormal;    // Simulated time of normal operation (s)
+static uint32_t g_uiTrips;  // Trips during normal operation
+static uint16_t g_uiStallMax;   // Longest stall test run (intervals)
+static uint16_t g_uiDirMax;     // Longest direction test run (intervals)
+
+//----------------------------------------------------------------------------
+// FUNCTION : FLT_Start( float fNoise, float fFric )
+// PURPOSE  : Starts a simulation.
+//----------------------------------------------------------------------------
+
+static void FLT_Start( float fNoise, float fFric )
+{
+    SIM_Init();
+
+    g_SIM.fNoise = fNoise;
+    g_SIM.fFric  = fFric;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FLT_Latency( uint8_t uiFault, float fSP )
+// PURPOSE  : Returns the time from injecting a fault to the trip (ms).
+//----------------------------------------------------------------------------
+
+static float FLT_Latency( uint8_t uiFault, float fSP )
+{
+    uint32_t i;
+
+    FLT_Start( FLT_NOISE, FLT_FRIC );
+
+    MOTOR_SetSetpoint( &g_MCP, fSP );
+    SIM_Run( 3.0f );
+
+    HOST_CHECK( !g_aFLT[ 0 ].bLatched );
+
+    switch( uiFault )
+    {
+    case FLT_JAM:       g_SIM.bJam = true;       break;
+    case FLT_ENCODER:   g_SIM.bNoEncoder = true; break;
+    case FLT_SWAPPED:   g_SIM.bSwapped = true;   break;
+    case FLT_PHASE:
+        HWREG( g_MCP.pAxis->uiQEIBase + QEI_O_RIS ) |= ( 1 << 3 );
+        break;
+    }
+
+    for( i = 1; i <= ( uint32_t )( FLT_LIMIT / MOTOR_CONTROL_DT ); i++ )
+    {
+        SIM_Tick();
+        if( g_aFLT[ 0 ].bLatched ) break;
+    }
+
+    if( !g_aFLT[ 0 ].bLatched )
+    {
+        HOST_CHECK( g_aFLT[ 0 ].bLatched );
+        return -1.0f;
+    }
+
+    HOST_CHECK( g_aFLT[ 0 ].uiCause & g_auCause[ uiFault ] );
+
+    // Every PWM period of the next interval at zero duty
+    SIM_Tick();
+    HOST_CHECK( g_SIM.fDuty == 0.0f );
+
+    return i * MOTOR_CONTROL_DT * 1000.0f;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FLT_Normal( float fSeconds )
+// PURPOSE  : Runs normal operation for fSeconds, counting any trip (and
+//            clearing it to carry on).
+//----------------------------------------------------------------------------
+
+static void FLT_Normal( float fSeconds )
+{
+    uint32_t i;
+
+    for( i = 0; i < ( uint32_t )( fSeconds / MOTOR_CONTROL_DT ); i++ )
+    {
+        SIM_Tick();
+
+        if( g_aFLT[ 0 ].uiStallCount > g_uiStallMax ) g_uiStallMax = g_aFLT[ 0 ].uiStallCount;
+        if( g_aFLT[ 0 ].uiDirCount > g_uiDirMax )     g_uiDirMax   = g_aFLT[ 0 ].uiDirCount;
+
+        if( g_aFLT[ 0 ].bLatched )
+        {
+            printf( "  Trip cause 0x%02X at %.3f s\n", g_aFLT[ 0 ].uiCause, g_SIM.dTime );
+            FAULT_Clear( &g_aFLT[ 0 ], &g_MCP );
+            g_uiTrips++;
+        }
+    }
+
+    g_dNormal += fSeconds;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FLT_Report( const char *sName, double dFrom, uint32_t uiFrom )
+// PURPOSE  : Reports the normal operation since dFrom seconds and uiFrom
+//            trips, and the longest test runs.
+//----------------------------------------------------------------------------
+
+static void FLT_Report( const char *sName, double dFrom, uint32_t uiFrom )
+{
+    printf( "%-30s %5.0f s %6u %9u %9u\n", sName, g_dNormal - dFrom, g_uiTrips - uiFrom,
+            g_uiStallMax, g_uiDirMax );
+
+    g_uiStallMax = 0;
+    g_uiDirMax   = 0;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    uint32_t i, j;
+
+    printf( "Detection latency (ms)\n" );
+    printf( "Fault           " );
+    for( j = 0; j < FLT_SPEEDS; j++ ) printf( "%5.0f RPM", g_afSpeed[ j ] );
+    printf( "\n" );
+
+    for( i = 0; i < FLT_NUM; i++ )
+    {
+        printf( "%-16s", g_asName[ i ] );
+        for( j = 0; j < FLT_SPEEDS; j++ ) printf( "%9.0f", FLT_Latency( i, g_afSpeed[ j ] ) );
+        printf( "\n" );
+    }
+
+    printf( "%-30s %7s %6s %9s %9s\n", "Normal operation", "Time", "Trips", "Stall run", "Dir run" );
+
+    double dFrom;
+    uint32_t uiFrom;
+
+    // Default recipe: ramps, 60 to 120 RPM, a reversal and a stop, looped
+    dFrom = g_dNormal; uiFrom = g_uiTrips;
+    FLT_Start( FLT_NOISE, FLT_FRIC );
+    SEQ_Start( &g_SEQ );
+    FLT_Normal( 50.0f );
+    FLT_Report( "Recipe with reversals", dFrom, uiFrom );
+
+    // Load steps up and down at 80 RPM
+    dFrom = g_dNormal; uiFrom = g_uiTrips;
+    FLT_Start( FLT_NOISE, FLT_FRIC );
+    MOTOR_SetSetpoint( &g_MCP, 80.0f );
+    for( i = 0; i < 20; i++ )
+    {
+        g_SIM.fLoad = ( i & 1 ) ? 0.15f : 0.0f;
+        FLT_Normal( 2.0f );
+    }
+    FLT_Report( "Load steps 0.15 at 80 RPM", dFrom, uiFrom );
+
+    // Starts from rest against high static friction
+    dFrom = g_dNormal; uiFrom = g_uiTrips;
+    FLT_Start( FLT_NOISE, 0.2f );
+    for( i = 0; i < 10; i++ )
+    {
+        MOTOR_SetSetpoint( &g_MCP, 30.0f );
+        FLT_Normal( 2.0f );
+        MOTOR_SetSetpoint( &g_MCP, 0.0f );
+        FLT_Normal( 2.0f );
+    }
+    FLT_Report( "Starts against friction 0.2", dFrom, uiFrom );
+
+    // Slow running with heavy load noise
+    dFrom = g_dNormal; uiFrom = g_uiTrips;
+    FLT_Start( 0.05f, FLT_FRIC );
+    MOTOR_SetSetpoint( &g_MCP, 10.0f );
+    FLT_Normal( 60.0f );
+    FLT_Report( "10 RPM, load noise 0.05", dFrom, uiFrom );
+
+    printf( "False trips: %u in %.0f s (limits: stall %u, direction %u intervals)\n",
+            g_uiTrips, g_dNormal, FAULT_STALL_TIME, FAULT_DIR_TIME );
+
+    HOST_CHECK( g_uiTrips == 0 );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_FAULT.C
+//----------------------------------------------------------------------------
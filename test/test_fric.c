@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_FRIC.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Breakaway friction compensation (fric.c, MOTOR_FrictionFF) on the plant
+// simulation with stiction: the shaft does not turn below FRIC_TEST_BREAK
+// duty at rest, and FRIC_TEST_COULOMB opposes it once it turns.
+//
+// Built twice: test_fric with the compensation and test_fric_noff with
+// MOTOR_NO_FRICTION_FF, so both run the same plant and cases:
+//
+//     Calibration   the breakaway duty measured in each direction must be
+//                   the plant's to within FRIC_TEST_TOL
+//     Rise          small setpoint steps from rest, the time to 90 % of the
+//                   setpoint; every setpoint from FRIC_TEST_REACH up must
+//                   be reached and none below it, and 20 RPM within
+//                   FRIC_TEST_RISE with the compensation but not without
+//
+// Below FRIC_TEST_REACH the shaft stops short of the setpoint in both builds
+// (see fric.c), so those steps are reported but not compared.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+#include "fric.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#ifdef MOTOR_USE_FRICTION_FF
+#define FRIC_TEST_NAME  "FRIC on "
+#define FRIC_TEST_REACH 10.0f     // Lowest setpoint reached from rest (RPM)
+#else
+#define FRIC_TEST_NAME  "FRIC off"
+#define FRIC_TEST_REACH 20.0f
+#endif
+
+#define FRIC_TEST_BREAK   0.15f   // Breakaway friction (duty)
+#define FRIC_TEST_COULOMB 0.10f   // Running friction (duty)
+#define FRIC_TEST_TOL     0.01f   // Calibration tolerance (duty)
+#define FRIC_TEST_FAST    20.0f   // Setpoint timed against FRIC_TEST_RISE (RPM)
+#define FRIC_TEST_RISE    0.2f    // Time to 90 % of it with the compensation (s)
+#define FRIC_TEST_LIMIT   5.0f    // Longest wait (s)
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern FRIC_PARAMS g_aFRIC[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : FRIC_TestStart( void )
+// PURPOSE  : Starts a simulation with stiction.
+//----------------------------------------------------------------------------
+
+static void FRIC_TestStart( void )
+{
+    SIM_Init();
+
+    g_SIM.fFric     = FRIC_TEST_COULOMB;
+    g_SIM.fStiction = FRIC_TEST_BREAK;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : FRIC_TestRise( float fSP )
+// PURPOSE  : Returns the time from a step at rest to 90 % of the setpoint
+//            (s, -1 if not reached).
+//----------------------------------------------------------------------------
+
+static float FRIC_TestRise( float fSP )
+{
+    uint32_t i;
+
+    FRIC_TestStart();
+    MOTOR_SetSetpoint( &g_MCP, fSP );
+
+    for( i = 1; i <= ( uint32_t )( FRIC_TEST_LIMIT / MOTOR_CONTROL_DT ); i++ )
+    {
+        SIM_Tick();
+        if( g_SIM.fSpeed >= 0.9f * fSP ) return i * MOTOR_CONTROL_DT;
+    }
+
+    return -1.0f;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    static const float afSP[] = { 2.0f, 5.0f, 10.0f, 20.0f };
+    uint32_t i;
+
+    // Calibration (saved to the MCP7940M SRAM, which SIM_Init keeps)
+    FRIC_TestStart();
+    FRIC_Start( &g_aFRIC[ 0 ] );
+
+    for( i = 0; ( i < ( uint32_t )( 20.0f / MOTOR_CONTROL_DT ) ) && !g_aFRIC[ 0 ].bDone; i++ )
+    {
+        SIM_Tick();
+    }
+    FRIC_Report( &g_aFRIC[ 0 ], &g_MCP );
+
+    HOST_CHECK( !g_aFRIC[ 0 ].bFailed );
+    HOST_CHECK( fabsf( g_MCP.afFric[ 0 ] - FRIC_TEST_BREAK ) < FRIC_TEST_TOL );
+    HOST_CHECK( fabsf( g_MCP.afFric[ 1 ] - FRIC_TEST_BREAK ) < FRIC_TEST_TOL );
+
+    // Time to speed
+    printf( "%s time to 90 %% of the setpoint from rest (s)\n", FRIC_TEST_NAME );
+
+    for( i = 0; i < sizeof( afSP ) / sizeof( afSP[ 0 ] ); i++ )
+    {
+        float fRise = FRIC_TestRise( afSP[ i ] );
+
+        printf( "%s %5.1f RPM  %6.3f\n", FRIC_TEST_NAME, afSP[ i ], fRise );
+
+        HOST_CHECK( ( fRise >= 0.0f ) == ( afSP[ i ] >= FRIC_TEST_REACH ) );
+
+        if( afSP[ i ] == FRIC_TEST_FAST )
+        {
+#ifdef MOTOR_USE_FRICTION_FF
+            HOST_CHECK( fRise < FRIC_TEST_RISE );
+#else
+            HOST_CHECK( fRise > FRIC_TEST_RISE );
+#endif
+        }
+    }
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_FRIC.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_ILC.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Iterative learning control (ilc.c) on the plant simulation.
+//
+// The PID runs a repeated conveyor cycle: a ramp up, a hold during which
+// a load is picked up and dropped again, a ramp down and a stop, with
+// load torque noise throughout. The main loop publishes the setpoint every
+// control interval and runs ILC_Learn as main.c does. The RMS tracking
+// error of each cycle, against the simulated shaft speed, must shrink as
+// the correction is learned.
+//
+// The cost of ILC_Apply is host time (not Cortex-M4 cycles).
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "host.h"
+#include "sim.h"
+#include "ilc.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define CYCLE_PERIOD    2.0f    // Cycle length (s)
+#define CYCLE_RAMP      0.4f    // Ramp time (s)
+#define CYCLE_HOLD      0.6f    // Hold time (s)
+#define CYCLE_RPM       120.0f  // Hold speed (RPM)
+#define CYCLE_LOAD      0.1f    // Load picked up during the hold (duty)
+#define CYCLE_NUM       20      // Cycles learned
+
+#define ILC_NOISE       0.02f   // Load torque noise (duty RMS)
+#define ILC_FRIC        0.03f   // Coulomb friction (duty)
+#define ILC_CALLS       2000000     // ILC_Apply calls timed per run
+#define ILC_REPEAT      5           // Runs timed (the lowest is reported)
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern ILC_PARAMS g_aILC[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : CYCLE_Setpoint( float t )
+// PURPOSE  : Returns the setpoint at t seconds into the cycle (and sets the
+//            load for that point).
+//----------------------------------------------------------------------------
+
+static float CYCLE_Setpoint( float t )
+{
+    float fHold = CYCLE_RAMP + CYCLE_HOLD;
+
+    g_SIM.fLoad = ( t >= CYCLE_RAMP + 0.2f ) && ( t < fHold - 0.1f ) ? CYCLE_LOAD : 0.0f;
+
+    if( t < CYCLE_RAMP )            return CYCLE_RPM * t / CYCLE_RAMP;
+    if( t < fHold )                 return CYCLE_RPM;
+    if( t < fHold + CYCLE_RAMP )    return CYCLE_RPM * ( 1.0f - ( ( t - fHold ) / CYCLE_RAMP ) );
+
+    return 0.0f;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : CYCLE_Run( bool bLearn, float *pfRms, float *pfIlc )
+// PURPOSE  : Runs CYCLE_NUM cycles, with or without learning, and returns
+//            the RMS error of each against the shaft speed (and as the ILC
+//            measured it).
+//----------------------------------------------------------------------------
+
+static void CYCLE_Run( bool bLearn, float *pfRms, float *pfIlc )
+{
+    uint32_t uiTicks = ( uint32_t )( ( CYCLE_PERIOD / MOTOR_CONTROL_DT ) + 0.5f );
+    uint32_t n, i;
+
+    SIM_Init();
+
+    g_SIM.fNoise = ILC_NOISE;
+    g_SIM.fFric  = ILC_FRIC;
+
+    // One cycle to start up, then learning from a cycle boundary
+    for( i = 0; i < uiTicks; i++ )
+    {
+        MOTOR_SetSetpoint( &g_MCP, CYCLE_Setpoint( i * MOTOR_CONTROL_DT ) );
+        SIM_Tick();
+    }
+
+    if( bLearn ) ILC_Start( &g_aILC[ 0 ], CYCLE_PERIOD, MOTOR_CONTROL_DT );
+
+    for( n = 0; n < CYCLE_NUM; n++ )
+    {
+        double dSum = 0.0;
+
+        for( i = 0; i < uiTicks; i++ )
+        {
+            float fSP = CYCLE_Setpoint( i * MOTOR_CONTROL_DT );
+
+            MOTOR_SetSetpoint( &g_MCP, fSP );
+            SIM_Tick();
+
+            dSum += ( fSP - g_SIM.fSpeed ) * ( fSP - g_SIM.fSpeed );
+
+            // Main loop
+            ILC_Learn( &g_aILC[ 0 ] );
+        }
+
+        pfRms[ n ] = sqrt( dSum / uiTicks );
+        pfIlc[ n ] = g_aILC[ 0 ].fRms;
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    float afPid[ CYCLE_NUM ], afPidIlc[ CYCLE_NUM ];
+    float afRms[ CYCLE_NUM ], afIlc[ CYCLE_NUM ];
+    uint32_t n;
+
+    CYCLE_Run( false, afPid, afPidIlc );
+    CYCLE_Run( true, afRms, afIlc );
+
+    printf( "RMS tracking error per cycle (RPM)\n" );
+    printf( "Cycle   PID alone   With ILC   (ILC fRms)\n" );
+    for( n = 0; n < CYCLE_NUM; n++ )
+    {
+        printf( "%5u   %9.2f   %8.2f   %10.2f\n", n + 1, afPid[ n ], afRms[ n ], afIlc[ n ] );
+    }
+
+    // Shrinking over the first cycles, then well below the PID alone
+    float fPid = 0.0f, fIlc = 0.0f;
+
+    for( n = CYCLE_NUM - 5; n < CYCLE_NUM; n++ )
+    {
+        fPid += afPid[ n ] / 5.0f;
+        fIlc += afRms[ n ] / 5.0f;
+    }
+    printf( "Last 5 cycles: %.2f RPM alone, %.2f RPM with ILC\n", fPid, fIlc );
+
+    HOST_CHECK( afRms[ 2 ] < afRms[ 0 ] );
+    HOST_CHECK( afRms[ 4 ] < afRms[ 2 ] );
+    HOST_CHECK( fIlc < 0.5f * fPid );
+
+    // Per tick cost (a lookup and an add, plus the error sum)
+    // (the host is shared, so the quietest run is the cost)
+    struct timespec sStart, sEnd;
+    uint32_t i;
+    double dBest = 0.0;
+
+    for( n = 0; n < ILC_REPEAT; n++ )
+    {
+        clock_gettime( CLOCK_MONOTONIC, &sStart );
+        for( i = 0; i < ILC_CALLS; i++ )
+        {
+            ILC_Apply( &g_aILC[ 0 ], &g_MCP );
+        }
+        clock_gettime( CLOCK_MONOTONIC, &sEnd );
+
+        double dNs = ( ( sEnd.tv_sec - sStart.tv_sec ) * 1e9 ) + ( sEnd.tv_nsec - sStart.tv_nsec );
+        if( ( n == 0 ) || ( dNs < dBest ) ) dBest = dNs;
+    }
+
+    printf( "ILC_Apply host cost %.1f ns per control interval\n", dBest / ILC_CALLS );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_ILC.C
+//----------------------------------------------------------------------------
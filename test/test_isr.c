@@ -0,0 +1,291 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_ISR.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Cost of the control interrupt (Timer 0A) per axis on the plant
+// simulation.
+//
+// The handler is timed every control interval (see sim.c) while axis 0
+// runs each case. The shared part, the current sampling and the trace,
+// is timed on its own and taken off, which leaves the cost of an axis.
+// The host clock read around each call is calibrated out, and each figure
+// is the lowest of ISR_REPEAT runs (the host is shared).
+//
+// The duty cycle driver (MOTOR_SetDutyCycle) is also timed on its own
+// against the one it replaced, which read LOAD back and wrote GENA, GENB
+// and CMPA on every call (ISR_SetDutyOld), with the register accesses per
+// call counted. On the device these are PWM (APB) accesses, each of which
+// costs the bus more than the RAM access that replaced it.
+//
+// These are host figures (x86, -O2), not Cortex-M4 cycles: they rank the
+// cases and scale with the work done. The target figure comes from the
+// execution histogram of TRACE_Dump.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <time.h>
+
+#include "host.h"
+#include "sim.h"
+#include "current.h"
+#include "ilc.h"
+#include "seq.h"
+#include "trace.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define ISR_SECONDS     2.0f        // Simulated time per run
+#define ISR_CALLS       2000000     // Calls timed per run for the shared part
+#define ISR_REPEAT      15          // Runs per figure
+#define ISR_DUTY_STEPS  64          // Duties the driver cycles through
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern CURRENT_PARAMS g_CUR;
+extern ILC_PARAMS g_aILC[ MOTOR_NUM_AXES ];
+extern SEQ_PARAMS g_SEQ;
+
+static double g_dClock;     // Cost of the clock reads around a call (s)
+
+//----------------------------------------------------------------------------
+// FUNCTION : ISR_Seconds( const struct timespec *pStart )
+// PURPOSE  : Returns the host time since pStart (s).
+//----------------------------------------------------------------------------
+
+static double ISR_Seconds( const struct timespec *pStart )
+{
+    struct timespec sNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &sNow );
+
+    return ( sNow.tv_sec - pStart->tv_sec ) + ( ( sNow.tv_nsec - pStart->tv_nsec ) * 1e-9 );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : ISR_Calibrate( void )
+// PURPOSE  : Times the clock reads (g_dClock) and returns the cost of the
+//            shared part of the handler (s).
+//----------------------------------------------------------------------------
+
+static double ISR_Calibrate( void )
+{
+    struct timespec sStart, sA, sB;
+    double dShared = 1.0;
+    uint32_t i, n;
+
+    g_dClock = 1.0;
+
+    SIM_Init();
+
+    for( n = 0; n < ISR_REPEAT; n++ )
+    {
+        clock_gettime( CLOCK_MONOTONIC, &sStart );
+        for( i = 0; i < ISR_CALLS; i++ )
+        {
+            clock_gettime( CLOCK_MONOTONIC, &sA );
+            clock_gettime( CLOCK_MONOTONIC, &sB );
+        }
+        double dClock = ISR_Seconds( &sStart ) / ISR_CALLS;
+        if( dClock < g_dClock ) g_dClock = dClock;
+
+        clock_gettime( CLOCK_MONOTONIC, &sStart );
+        for( i = 0; i < ISR_CALLS; i++ )
+        {
+            TRACE_Enter();
+            CURRENT_Update( &g_CUR );
+            TRACE_Exit();
+        }
+        double dRun = ISR_Seconds( &sStart ) / ISR_CALLS;
+        if( dRun < dShared ) dShared = dRun;
+    }
+
+    return dShared;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : ISR_SetDutyOld( MOTOR_CONTROL_PARAMS *pMCP, float fMotorDC,
+//                            bool bMotorDir )
+// PURPOSE  : MOTOR_SetDutyCycle as it was before the generator state was
+//            kept in RAM.
+//----------------------------------------------------------------------------
+
+static void ISR_SetDutyOld( MOTOR_CONTROL_PARAMS *pMCP, float fMotorDC, bool bMotorDir )
+{
+    uint32_t uiPulse;
+    uint16_t uiBSH = MOTOR_BSH; // Time required to replenish bootstrap capacitor
+    uint32_t uiGen = pMCP->pAxis->uiPWMBase + pMCP->pAxis->uiPWMGen;
+
+    // Bootstrap (High Side)
+    uint16_t uiPulseMax = ( uint16_t )( HWREG( uiGen + PWM_O_X_LOAD ) );
+
+    // Set Direction
+    if( bMotorDir )
+    {
+        HWREG( uiGen + PWM_O_X_GENA ) = 0x000000B0; // Q6/Q8 PWM
+        HWREG( uiGen + PWM_O_X_GENB ) = 0x000000C3; // Q5 OFF, Q7 ON
+    }
+    else
+    {
+        HWREG( uiGen + PWM_O_X_GENA ) = 0x000000C3; // Q6 OFF, Q8 ON
+        HWREG( uiGen + PWM_O_X_GENB ) = 0x000000B0; // Q5/Q7 PWM
+    }
+
+    // Verify minimum and maximum (0.0 to the derated ceiling)
+    fMotorDC = fMotorDC < 0.0f ? 0.0f : fMotorDC;
+    fMotorDC = fMotorDC > pMCP->fDutyMax ? pMCP->fDutyMax : fMotorDC;
+
+    // Calculate pulse width (with MOTOR_DITHER_BITS of fraction)
+    uiPulse = ( uint32_t )( ( uiPulseMax * fMotorDC * ( 1 << MOTOR_DITHER_BITS ) ) + 0.5f );
+
+    // Limit maximum pulse width so that the bootstrap capacitor can charge
+    if( uiPulse > ( ( uint32_t )( uiPulseMax - uiBSH ) << MOTOR_DITHER_BITS ) )
+    {
+        uiPulse = ( uint32_t )( uiPulseMax - uiBSH ) << MOTOR_DITHER_BITS;
+    }
+
+#ifndef MOTOR_USE_DITHER
+    // Round to whole counts
+    uiPulse = ( uiPulse + ( 1 << ( MOTOR_DITHER_BITS - 1 ) ) ) & ~( ( 1 << MOTOR_DITHER_BITS ) - 1 );
+#endif
+    pMCP->uiPulseQ = uiPulse;
+
+    // Set motor duty cycle
+    HWREG( uiGen + PWM_O_X_CMPA ) = uiPulse >> MOTOR_DITHER_BITS;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : ISR_Driver( const char *sName, bool bOld, double *pTime,
+//                        double *pRegs )
+// PURPOSE  : Times a duty cycle driver (s) and counts its register accesses,
+//            per call, as the control loop calls it (a new duty every call,
+//            same direction).
+//----------------------------------------------------------------------------
+
+static void ISR_Driver( const char *sName, bool bOld, double *pTime, double *pRegs )
+{
+    struct timespec sStart;
+    double dCall = 1.0;
+    uint32_t i, n;
+
+    SIM_Init();
+
+    for( n = 0; n < ISR_REPEAT; n++ )
+    {
+        uint32_t uiRegs = HOST_Accesses();
+
+        clock_gettime( CLOCK_MONOTONIC, &sStart );
+        for( i = 0; i < ISR_CALLS; i++ )
+        {
+            float fDuty = 0.3f + ( ( i % ISR_DUTY_STEPS ) * 0.001f );
+
+            if( bOld ) ISR_SetDutyOld( &g_MCP, fDuty, g_MCP.bDir );
+            else       MOTOR_SetDutyCycle( &g_MCP, fDuty, g_MCP.bDir );
+        }
+        double dRun = ISR_Seconds( &sStart ) / ISR_CALLS;
+        if( dRun < dCall ) dCall = dRun;
+
+        *pRegs = ( double )( HOST_Accesses() - uiRegs ) / ISR_CALLS;
+    }
+
+    *pTime = dCall;
+
+    printf( "%-26s %6.1f ns   %6.2f\n", sName, dCall * 1e9, *pRegs );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : ISR_Case( const char *sName, uint8_t uiCase, double dShared )
+// PURPOSE  : Runs a case and reports the handler and per axis cost.
+//----------------------------------------------------------------------------
+
+static void ISR_Case( const char *sName, uint8_t uiCase, double dShared )
+{
+    double dIsr = 1.0;
+    uint32_t n;
+
+    for( n = 0; n < ISR_REPEAT; n++ )
+    {
+        SIM_Init();
+
+        MOTOR_SetSetpoint( &g_MCP, 60.0f );
+        SIM_Run( 2.0f );
+
+        if( uiCase == 1 ) SEQ_Start( &g_SEQ );
+        if( uiCase == 2 ) ILC_Start( &g_aILC[ 0 ], 1.0f, MOTOR_CONTROL_DT );
+
+        g_SIM.dIsrTime = 0.0;
+        g_SIM.uiTicks  = 0;
+
+        SIM_Run( ISR_SECONDS );
+
+        double dRun = ( g_SIM.dIsrTime / g_SIM.uiTicks ) - g_dClock;
+        if( dRun < dIsr ) dIsr = dRun;
+    }
+
+    printf( "%-26s %6.1f ns   %6.1f ns\n", sName, dIsr * 1e9, ( dIsr - dShared ) * 1e9 );
+
+    HOST_CHECK( dIsr > dShared );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    double dShared = ISR_Calibrate();
+
+    printf( "Control interrupt, host time per interval\n" );
+    printf( "Shared (current, trace)    %6.1f ns\n", dShared * 1e9 );
+    printf( "Case                       Handler     Per axis\n" );
+
+    ISR_Case( "Speed loop, 60 RPM", 0, dShared );
+    ISR_Case( "Recipe running", 1, dShared );
+    ISR_Case( "Learned correction (ILC)", 2, dShared );
+
+    // Duty cycle driver, before and after the RAM state
+    double dOld, dNew, dOldRegs, dNewRegs;
+
+    printf( "Duty cycle driver          Per call    Registers\n" );
+    ISR_Driver( "Read back (before)", true, &dOld, &dOldRegs );
+    ISR_Driver( "RAM state (after)", false, &dNew, &dNewRegs );
+
+    HOST_CHECK( dOldRegs == 4.0 );
+#ifdef MOTOR_USE_DITHER
+    HOST_CHECK( dNewRegs == 0.0 );
+#else
+    HOST_CHECK( dNewRegs <= 1.0 );
+#endif
+    HOST_CHECK( dNew < dOld );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_ISR.C
+//----------------------------------------------------------------------------
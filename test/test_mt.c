@@ -0,0 +1,219 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_MT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// M/T speed measurement benchmark (mt.c) on the plant simulation.
+//
+// Axis 0 runs open loop at a fixed duty, so any error is the
+// measurement's own. Three readings are compared:
+//
+//     Window    QEI_GetSpeed, the count of the last 150 ms window
+//     M/T       g_MT.fSpeed, edges over their exact span (every interval)
+//     Obs/MT    the axis' observer corrected by M/T (the PV of axis 0)
+//
+// Resolution is the RMS and peak error at a steady speed with load noise
+// of 5 % of the drive (without it some speeds give a whole number of
+// counts per window and the window error vanishes). Latency is the mean
+// delay of the reading behind the shaft speed over a +50 % step (the area
+// between the two over the step height, as in test_qei.c: a threshold
+// crossing is biased by where the next edge or window falls), averaged
+// over steps started at ten points across a window. M/T must beat the
+// window in error and latency at every speed, and so must the observer in
+// latency.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+#include "mt.h"
+#include "qei.h"
+#include "observer.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define MT_TEST_SETTLE  2.0f    // Time at the first speed before measuring (s)
+#define MT_TEST_MEASURE 3.0f    // Steady time measured (s)
+#define MT_TEST_STEP    1.5f    // Step to this times the speed
+#define MT_TEST_PHASES  10      // Step start points across a window
+#define MT_TEST_LIMIT   2.0f    // Time measured after the step (s)
+#define MT_TEST_NOISE   0.05f   // Steady load noise (of the duty)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagMT_RESULT
+{
+    float fRMS;         // Steady error (RPM)
+    float fPeak;
+    float fLatency;     // Mean delay over a step (s)
+
+} MT_RESULT;
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern MT_PARAMS g_MT;
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+
+static float g_fDuty;   // Open loop duty
+
+//----------------------------------------------------------------------------
+// FUNCTION : MT_Tick( void )
+// PURPOSE  : Runs a control interval with the duty applied over the
+//            firmware's.
+//----------------------------------------------------------------------------
+
+static void MT_Tick( void )
+{
+    SIM_Tick();
+
+    g_MCP.fDuty = g_fDuty;
+    MOTOR_SetDutyCycle( &g_MCP, g_fDuty, g_MCP.bDir );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MT_Start( float fRPM )
+// PURPOSE  : Starts a simulation settled at a speed.
+//----------------------------------------------------------------------------
+
+static void MT_Start( float fRPM )
+{
+    uint32_t i;
+
+    SIM_Init();
+    MOTOR_SetSetpoint( &g_MCP, fRPM * MT_TEST_STEP );
+
+    g_fDuty = fRPM / g_SIM.fKm;
+    for( i = 0; i < ( uint32_t )( MT_TEST_SETTLE / MOTOR_CONTROL_DT ); i++ ) MT_Tick();
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : MT_Case( float fRPM, MT_RESULT *pWin, MT_RESULT *pMT,
+//                     MT_RESULT *pObs )
+// PURPOSE  : Measures the readings at one speed.
+//----------------------------------------------------------------------------
+
+static void MT_Case( float fRPM, MT_RESULT *pWin, MT_RESULT *pMT, MT_RESULT *pObs )
+{
+    double dWin = 0.0, dMT = 0.0, dObs = 0.0;
+    uint32_t i, k;
+    uint32_t uiTicks = ( uint32_t )( MT_TEST_MEASURE / MOTOR_CONTROL_DT );
+    uint32_t uiWin;
+
+    // Resolution at a steady speed
+    MT_Start( fRPM );
+    uiWin = ( uint32_t )( ( QEI_GetWindow( g_MCP.pAxis ) / MOTOR_CONTROL_DT ) + 0.5f );
+    g_SIM.fNoise = MT_TEST_NOISE * g_fDuty;
+
+    pWin->fPeak = 0.0f;
+    pMT->fPeak  = 0.0f;
+    pObs->fPeak = 0.0f;
+
+    for( i = 0; i < uiTicks; i++ )
+    {
+        MT_Tick();
+
+        float fWin = fabsf( QEI_GetSpeed( g_MCP.pAxis ) - g_SIM.fSpeed );
+        float fMT  = fabsf( g_MT.fSpeed - g_SIM.fSpeed );
+        float fObs = fabsf( g_aOBS[ MT_AXIS ].fSpeed - g_SIM.fSpeed );
+
+        dWin += fWin * fWin;
+        dMT  += fMT * fMT;
+        dObs += fObs * fObs;
+        if( fWin > pWin->fPeak ) pWin->fPeak = fWin;
+        if( fMT > pMT->fPeak )   pMT->fPeak  = fMT;
+        if( fObs > pObs->fPeak ) pObs->fPeak = fObs;
+    }
+
+    pWin->fRMS = sqrt( dWin / uiTicks );
+    pMT->fRMS  = sqrt( dMT / uiTicks );
+    pObs->fRMS = sqrt( dObs / uiTicks );
+
+    // Latency over a step, started across a window
+    float fHeight = fRPM * ( MT_TEST_STEP - 1.0f );
+    double dLatWin = 0.0, dLatMT = 0.0, dLatObs = 0.0;
+
+    for( k = 0; k < MT_TEST_PHASES; k++ )
+    {
+        MT_Start( fRPM );
+        for( i = 0; i < ( k * uiWin ) / MT_TEST_PHASES; i++ ) MT_Tick();
+
+        g_fDuty = fRPM * MT_TEST_STEP / g_SIM.fKm;
+
+        for( i = 0; i < ( uint32_t )( MT_TEST_LIMIT / MOTOR_CONTROL_DT ); i++ )
+        {
+            MT_Tick();
+
+            dLatWin += ( g_SIM.fSpeed - QEI_GetSpeed( g_MCP.pAxis ) ) * MOTOR_CONTROL_DT;
+            dLatMT  += ( g_SIM.fSpeed - g_MT.fSpeed ) * MOTOR_CONTROL_DT;
+            dLatObs += ( g_SIM.fSpeed - g_aOBS[ MT_AXIS ].fSpeed ) * MOTOR_CONTROL_DT;
+        }
+    }
+
+    pWin->fLatency = dLatWin / ( MT_TEST_PHASES * fHeight );
+    pMT->fLatency  = dLatMT / ( MT_TEST_PHASES * fHeight );
+    pObs->fLatency = dLatObs / ( MT_TEST_PHASES * fHeight );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    static const float afRPM[] = { 2.0f, 5.0f, 20.0f, 60.0f, 130.0f };
+    uint8_t i;
+
+    printf( "Error against the shaft speed (RPM), mean delay over a +50 %% step (ms)\n" );
+    printf( "             Window RMS/pk/lat         M/T RMS/pk/lat      Obs/MT RMS/pk/lat\n" );
+
+    for( i = 0; i < sizeof( afRPM ) / sizeof( afRPM[ 0 ] ); i++ )
+    {
+        MT_RESULT sWin, sMT, sObs;
+
+        MT_Case( afRPM[ i ], &sWin, &sMT, &sObs );
+
+        printf( "%5.0f RPM  %6.2f %5.2f %6.1f    %6.3f %5.3f %6.1f    %6.3f %5.3f %6.1f\n",
+                afRPM[ i ], sWin.fRMS, sWin.fPeak, sWin.fLatency * 1000.0f,
+                sMT.fRMS, sMT.fPeak, sMT.fLatency * 1000.0f,
+                sObs.fRMS, sObs.fPeak, sObs.fLatency * 1000.0f );
+
+        HOST_CHECK( sMT.fRMS < sWin.fRMS );
+        HOST_CHECK( sMT.fLatency < sWin.fLatency );
+        HOST_CHECK( sObs.fLatency < sWin.fLatency );
+    }
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_MT.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,212 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_OBSERVER.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Speed observer benchmark (observer.c) on the plant simulation.
+//
+// The PID runs axis 0 in closed loop while the estimates are compared with
+// the simulated shaft speed every control interval:
+//
+//     Window    QEI_GetSpeed, the count of the last 150 ms window (the PV
+//               before the observer)
+//     Obs/QEI   the observer corrected at the end of each QEI window, run
+//               alongside on the same duty
+//     Obs/MT    the axis' own observer, corrected by the M/T measurement
+//               every interval (MT_AXIS)
+//
+// Each case runs with load torque noise. The steady cases hold a speed;
+// the step case steps the setpoint and then the load while measuring.
+// The M/T observer must beat the window count in every case, the window
+// observer in the step case (at a steady speed the loop cancels most of
+// the load noise, which the window observer then predicts from the duty as
+// a speed change that does not happen). The CPU cost is
+// host time per control interval (a prediction, and a correction every
+// window, the lowest of OBS_CPU_REPEAT runs), not Cortex-M4 cycles;
+// TRACE_Dump gives those on the target.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "host.h"
+#include "sim.h"
+#include "observer.h"
+#include "qei.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define OBS_NOISE       0.02f   // Load torque noise (duty RMS)
+#define OBS_SETTLE      3.0f    // Time before measuring (s)
+#define OBS_MEASURE     3.0f    // Time measured (s)
+
+#define OBS_CPU_TICKS   2000000 // Control intervals timed per run
+#define OBS_CPU_REPEAT  5       // Runs timed (the lowest is reported)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagOBS_ERROR
+{
+    double dWindow;     // Sums of squared errors (RPM^2)
+    double dQEI;
+    double dMT;
+    uint32_t uiN;
+
+} OBS_ERROR;
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
+
+static OBSERVER_PARAMS g_OBS;   // Observer corrected by the QEI window
+
+//----------------------------------------------------------------------------
+// FUNCTION : OBS_Tick( OBS_ERROR *pErr )
+// PURPOSE  : Runs one control interval and the window observer, and
+//            accumulates the errors (if pErr).
+//----------------------------------------------------------------------------
+
+static void OBS_Tick( OBS_ERROR *pErr )
+{
+    float fDuty = g_MCP.fDuty;
+
+    SIM_Tick();
+
+    // The window interrupt came before the control interrupt
+    if( g_SIM.uiWinTicks == 0 ) OBSERVER_Correct( &g_OBS, QEI_GetVelocity( g_MCP.pAxis ) );
+    OBSERVER_Predict( &g_OBS, fDuty );
+
+    if( !pErr ) return;
+
+    float fTrue = g_SIM.fSpeed;
+    float fWin  = QEI_GetSpeed( g_MCP.pAxis ) - fTrue;
+    float fQEI  = g_OBS.fSpeed - fTrue;
+    float fMT   = g_aOBS[ 0 ].fSpeed - fTrue;
+
+    pErr->dWindow += fWin * fWin;
+    pErr->dQEI    += fQEI * fQEI;
+    pErr->dMT     += fMT * fMT;
+    pErr->uiN++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : OBS_Case( const char *sName, float fSP, bool bSteps )
+// PURPOSE  : Runs and reports one case.
+//----------------------------------------------------------------------------
+
+static void OBS_Case( const char *sName, float fSP, bool bSteps )
+{
+    OBS_ERROR sErr = { 0.0, 0.0, 0.0, 0 };
+    uint32_t i;
+    uint32_t uiTicks = ( uint32_t )( OBS_MEASURE / MOTOR_CONTROL_DT );
+
+    SIM_Init();
+    OBSERVER_Init( &g_OBS, QEI_GetWindow( g_MCP.pAxis ) );
+    g_SIM.fNoise = OBS_NOISE;
+
+    MOTOR_SetSetpoint( &g_MCP, fSP );
+    for( i = 0; i < ( uint32_t )( OBS_SETTLE / MOTOR_CONTROL_DT ); i++ ) OBS_Tick( NULL );
+
+    for( i = 0; i < uiTicks; i++ )
+    {
+        if( bSteps && ( i == 0 ) ) MOTOR_SetSetpoint( &g_MCP, 2.0f * fSP );
+        if( bSteps && ( i == uiTicks / 2 ) ) g_SIM.fLoad = 0.1f;
+
+        OBS_Tick( &sErr );
+    }
+
+    float fWin = sqrt( sErr.dWindow / sErr.uiN );
+    float fQEI = sqrt( sErr.dQEI / sErr.uiN );
+    float fMT  = sqrt( sErr.dMT / sErr.uiN );
+
+    printf( "%-18s %8.2f %8.2f %8.2f\n", sName, fWin, fQEI, fMT );
+
+    // Steady, the 1 kHz loop holds the shaft so well that the window count
+    // is close; the window observer earns its place when the speed moves
+    if( bSteps ) HOST_CHECK( fQEI < fWin );
+    HOST_CHECK( fMT < fWin );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : OBS_Cost( void )
+// PURPOSE  : Times the observer (host).
+//----------------------------------------------------------------------------
+
+static void OBS_Cost( void )
+{
+    struct timespec sStart, sEnd;
+    uint32_t i, n;
+    uint16_t uiWin = ( uint16_t )( QEI_GetWindow( g_MCP.pAxis ) / MOTOR_CONTROL_DT );
+    double dBest = 0.0;
+
+    OBSERVER_Init( &g_OBS, QEI_GetWindow( g_MCP.pAxis ) );
+
+    // The host is shared, so the quietest run is the cost
+    for( n = 0; n < OBS_CPU_REPEAT; n++ )
+    {
+        clock_gettime( CLOCK_MONOTONIC, &sStart );
+        for( i = 0; i < OBS_CPU_TICKS; i++ )
+        {
+            if( ( i % uiWin ) == 0 ) OBSERVER_Correct( &g_OBS, 60.0f );
+            OBSERVER_Predict( &g_OBS, 0.3f );
+        }
+        clock_gettime( CLOCK_MONOTONIC, &sEnd );
+
+        double dNs = ( ( sEnd.tv_sec - sStart.tv_sec ) * 1e9 ) + ( sEnd.tv_nsec - sStart.tv_nsec );
+        if( ( n == 0 ) || ( dNs < dBest ) ) dBest = dNs;
+    }
+
+    printf( "Host cost %.1f ns per control interval (estimate %.1f RPM)\n",
+            dBest / OBS_CPU_TICKS, g_OBS.fSpeed );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    printf( "RMS error against the shaft speed (RPM)\n" );
+    printf( "Case                 Window  Obs/QEI   Obs/MT\n" );
+
+    OBS_Case( "20 RPM",             20.0f, false );
+    OBS_Case( "65 RPM",             65.0f, false );
+    OBS_Case( "130 RPM",           130.0f, false );
+    OBS_Case( "65-130 RPM, load",   65.0f, true );
+
+    OBS_Cost();
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_OBSERVER.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_PWM.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Current sample timing (current.c) against the bridge drive (motor.c) on
+// the plant simulation.
+//
+// Axis 0 runs open loop at several duties in each direction, against a
+// load. From the registers MOTOR_Init and CURRENT_Init program, each PWM
+// period is replayed count by count to find the conduction window (a high
+// side switch on, so the shunt carries the winding current) and the time
+// of the generator's ADC trigger:
+//
+//     Window    the trigger is at the middle of the window, to within a
+//               count, and at least PWM_TEST_MARGIN from its edges where
+//               the window is wide enough
+//     Sample    the sample the ADC took there is the winding current, to
+//               within a count
+//
+// The outputs are active low (an output low turns its high side on, see
+// MOTOR_SetBridge), so the window is centered on counter zero and the low
+// sides conduct around LOAD, where the shunt reads nothing; that is
+// checked too.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+#include "current.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define PWM_TEST_LOAD   0.2f    // Load torque (duty)
+#define PWM_TEST_SETTLE 0.5f    // Time at a duty before checking (s)
+#define PWM_TEST_MARGIN 20      // Trigger to a switching edge (counts, 0.5 us)
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void PWM0_GEN0_IntHandler( void );
+
+//----------------------------------------------------------------------------
+// FUNCTION : PWM_TestDuty( float fDuty, bool bDir )
+// PURPOSE  : Runs a duty and checks the trigger against the window.
+//----------------------------------------------------------------------------
+
+static void PWM_TestDuty( float fDuty, bool bDir )
+{
+    const MOTOR_AXIS *pAxis;
+    uint32_t uiGen;
+    int8_t   iDir = bDir ? 1 : -1;
+    uint32_t uiPeriod, uiOff, uiOn = 0, t;
+    int32_t  iStart = -1, iEnd = -1;
+    uint32_t i;
+
+    SIM_Init();
+    g_SIM.fLoad = bDir ? PWM_TEST_LOAD : -PWM_TEST_LOAD;
+    g_MCP.bDir  = bDir;
+
+    pAxis = g_MCP.pAxis;
+    uiGen = pAxis->uiPWMBase + pAxis->uiPWMGen;
+
+    // The firmware's duty replaced after each interval
+    for( i = 0; i < ( uint32_t )( PWM_TEST_SETTLE / MOTOR_CONTROL_DT ); i++ )
+    {
+        g_MCP.fDuty = fDuty;
+        MOTOR_SetDutyCycle( &g_MCP, fDuty, bDir );
+        SIM_Tick();
+    }
+
+    // The sample of the last period against the winding current
+    float fSample = g_SIM.uiSample * CURRENT_AMPS_PER_COUNT;
+    float fWinding = bDir ? g_SIM.fCurrent : -g_SIM.fCurrent;
+
+    // The same period replayed: the generator state of the duty
+    MOTOR_SetDutyCycle( &g_MCP, fDuty, bDir );
+    PWM0_GEN0_IntHandler();
+
+    uiPeriod = 2 * HWREG( uiGen + PWM_O_X_LOAD );
+    int32_t iTrig = SIM_Trigger();
+
+    // Window: the drive in the direction over a period from a time without
+    // it (it may wrap past zero)
+    for( uiOff = 0; ( uiOff < uiPeriod ) && SIM_Drive( uiOff ); uiOff++ );
+
+    for( t = uiOff; t < uiOff + uiPeriod; t++ )
+    {
+        if( SIM_Drive( t % uiPeriod ) == iDir )
+        {
+            if( iStart < 0 ) iStart = t;
+            iEnd = t;
+            uiOn++;
+        }
+    }
+
+    int32_t iMid  = ( iStart + ( uiOn / 2 ) ) % uiPeriod;
+    int32_t iDist = abs( iTrig - iMid );
+
+    if( iDist > ( int32_t )( uiPeriod / 2 ) ) iDist = uiPeriod - iDist;
+
+    printf( "%4.2f  %s  %4lu  %5ld  %5ld  %5ld   %.3f A  %.3f A\n",
+            fDuty, bDir ? "fwd" : "rev", ( unsigned long )uiOn,
+            ( long )( iStart % uiPeriod ), ( long )iMid, ( long )iTrig, fSample, fWinding );
+
+    // One run, so one window
+    HOST_CHECK( ( uiOn > 0 ) && ( ( uint32_t )( iEnd - iStart + 1 ) == uiOn ) );
+    HOST_CHECK( iTrig >= 0 );
+    HOST_CHECK( iDist <= 1 );
+    HOST_CHECK( ( uiOn < ( 2 * PWM_TEST_MARGIN ) ) || ( iDist + PWM_TEST_MARGIN <= ( int32_t )( uiOn / 2 ) ) );
+    HOST_CHECK( fabsf( fSample - fWinding ) <= CURRENT_AMPS_PER_COUNT );
+
+    // Around LOAD the low sides conduct and the shunt reads nothing
+    HOST_CHECK( SIM_Drive( uiPeriod / 2 ) == 0 );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    static const float afDuty[] = { 0.05f, 0.2f, 0.5f, 0.8f, MOTOR_DUTY_MAX };
+    uint32_t i;
+
+    printf( "Duty  Dir    On  Start    Mid  Trigger  Sample   Winding (counts from zero)\n" );
+
+    for( i = 0; i < sizeof( afDuty ) / sizeof( afDuty[ 0 ] ); i++ )
+    {
+        PWM_TestDuty( afDuty[ i ], true );
+        PWM_TestDuty( afDuty[ i ], false );
+    }
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_PWM.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,198 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_QEI.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// QEI velocity measurement mode benchmark (g_aQEIMode in qei.c) on the
+// plant simulation. It is built once per mode, with QEI_MODE_AXIS0 given
+// on the command line (see the Makefile).
+//
+// Axis 0 runs open loop at a fixed duty, and QEI_GetVelocity (the mode's
+// averaged reading) is compared with the simulated shaft speed:
+//
+//     Noise     RMS error at ten steady speeds from 20 to 131 RPM, without
+//               load noise, so it is the quantisation of the reading alone
+//     Latency   mean delay of the reading behind the shaft speed over a
+//               60 to 90 RPM step (the area between the two over the step
+//               height, which a one count quantum does not bias the way a
+//               threshold crossing is), averaged over steps started at ten
+//               points across a window
+//
+// The simulation has no input glitches, so the filter is not exercised.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+#include "qei.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define QT_SETTLE       2.0f    // Time at a speed before measuring (s)
+#define QT_MEASURE      3.0f    // Steady time measured per speed (s)
+#define QT_SPEEDS       10      // Steady speeds
+#define QT_SPEED_MIN    20.5f   // First steady speed (RPM)
+#define QT_SPEED_STEP   12.3f   // Between steady speeds (RPM)
+#define QT_STEP_FROM    60.0f   // Latency step (RPM)
+#define QT_STEP_TO      90.0f
+#define QT_PHASES       10      // Step start points across a window
+#define QT_LIMIT        2.0f    // Time measured after the step (s)
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+extern const QEI_MODE g_aQEIMode[ QEI_NUM_MODES ];
+extern QEI_PARAMS g_aQEI[ MOTOR_MAX_AXES ];
+
+static const char *g_asModeName[ QEI_NUM_MODES ] =
+{
+    "FAST", "STANDARD", "FILTERED", "SMOOTH", "PREDIV"
+};
+
+static float g_fDuty;   // Open loop duty
+
+//----------------------------------------------------------------------------
+// FUNCTION : QT_Tick( void )
+// PURPOSE  : Runs a control interval with the duty applied over the
+//            firmware's.
+//----------------------------------------------------------------------------
+
+static void QT_Tick( void )
+{
+    SIM_Tick();
+
+    g_MCP.fDuty = g_fDuty;
+    MOTOR_SetDutyCycle( &g_MCP, g_fDuty, g_MCP.bDir );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QT_Start( float fRPM )
+// PURPOSE  : Starts a simulation settled at a speed.
+//----------------------------------------------------------------------------
+
+static void QT_Start( float fRPM )
+{
+    uint32_t i;
+
+    SIM_Init();
+    MOTOR_SetSetpoint( &g_MCP, fRPM );
+
+    g_fDuty = fRPM / g_SIM.fKm;
+    for( i = 0; i < ( uint32_t )( QT_SETTLE / MOTOR_CONTROL_DT ); i++ ) QT_Tick();
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QT_Noise( void )
+// PURPOSE  : Returns the RMS error at steady speeds (RPM).
+//----------------------------------------------------------------------------
+
+static float QT_Noise( void )
+{
+    double dSum = 0.0;
+    uint32_t uiN = 0;
+    uint32_t i, k;
+
+    for( k = 0; k < QT_SPEEDS; k++ )
+    {
+        QT_Start( QT_SPEED_MIN + ( k * QT_SPEED_STEP ) );
+
+        for( i = 0; i < ( uint32_t )( QT_MEASURE / MOTOR_CONTROL_DT ); i++ )
+        {
+            QT_Tick();
+
+            float fErr = QEI_GetVelocity( g_MCP.pAxis ) - g_SIM.fSpeed;
+
+            dSum += fErr * fErr;
+            uiN++;
+        }
+    }
+
+    return sqrt( dSum / uiN );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : QT_Latency( void )
+// PURPOSE  : Returns the mean delay of the reading over a step (s).
+//----------------------------------------------------------------------------
+
+static float QT_Latency( void )
+{
+    double dArea = 0.0;
+    uint32_t i, k;
+
+    for( k = 0; k < QT_PHASES; k++ )
+    {
+        QT_Start( QT_STEP_FROM );
+
+        uint32_t uiWin = ( uint32_t )( ( QEI_GetWindow( g_MCP.pAxis ) / MOTOR_CONTROL_DT ) + 0.5f );
+        for( i = 0; i < ( k * uiWin ) / QT_PHASES; i++ ) QT_Tick();
+
+        g_fDuty = QT_STEP_TO / g_SIM.fKm;
+
+        for( i = 0; i < ( uint32_t )( QT_LIMIT / MOTOR_CONTROL_DT ); i++ )
+        {
+            QT_Tick();
+
+            dArea += ( g_SIM.fSpeed - QEI_GetVelocity( g_MCP.pAxis ) ) * MOTOR_CONTROL_DT;
+        }
+    }
+
+    return dArea / ( QT_PHASES * ( QT_STEP_TO - QT_STEP_FROM ) );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    float fNoise   = QT_Noise();
+    float fLatency = QT_Latency();
+
+    const QEI_PARAMS *pQEI = &g_aQEI[ 0 ];
+    const QEI_MODE *pMode  = pQEI->pMode;
+
+    printf( "Mode       Window  Div  Filter  Avg  Latency  Noise (RPM RMS)\n" );
+    printf( "%-9s  %3.0f ms  %3u  %6u  %3u  %4.0f ms  %.2f\n",
+            g_asModeName[ pMode - g_aQEIMode ], pMode->fWindow * 1000.0f,
+            1u << pMode->uiVelDiv, pMode->uiFilter, pMode->uiAvg,
+            fLatency * 1000.0f, fNoise );
+
+    // Within the quantisation of one count over the averaged span, and
+    // reported no later than the span plus a window
+    float fCount = ( pQEI->fAvgScale * ( 1u << pMode->uiVelDiv ) );
+    float fSpan  = pMode->fWindow * ( pMode->uiAvg + 1 );
+
+    HOST_CHECK( fNoise < fCount );
+    HOST_CHECK( ( fLatency > 0.0f ) && ( fLatency < fSpan ) );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_QEI.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,210 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_REJECT.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Disturbance rejection of the speed loop on the plant simulation.
+//
+// A sinusoidal load torque is added to a constant one at a constant
+// setpoint, and the speed response at that frequency (lock-in over whole
+// periods) is divided by the open loop response of the plant model. The
+// ratio is the sensitivity |S|: below one the loop rejects the load. The
+// rejection bandwidth is where |S| rises through -3 dB.
+//
+//     Window    the loop as it was before the fast control rate: the PID
+//               adjusts the duty by 0.005 per RPM once per QEI window,
+//               from the window speed (QEI_GetSpeed); emulated here by
+//               applying that duty over whatever the firmware loop set
+//     1 kHz     the firmware loop, PID every control interval on the
+//               observer speed
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host.h"
+#include "sim.h"
+#include "qei.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define REJECT_SP       80.0f   // Setpoint (RPM)
+#define REJECT_LOAD     0.1f    // Constant load (duty)
+#define REJECT_AMP      0.02f   // Sinusoidal load amplitude (duty)
+#define REJECT_FRIC     0.03f   // Coulomb friction (duty)
+
+#define REJECT_KP       0.005f  // Window loop gain (duty per RPM per window)
+
+#define REJECT_SETTLE   3.0f    // Shortest settling time (s)
+#define REJECT_MEASURE  4.0f    // Shortest measurement (s)
+
+#define REJECT_3DB      0.7071f
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+static const float g_afHz[] = { 0.1f, 0.2f, 0.5f, 1.0f, 2.0f, 5.0f, 10.0f, 20.0f };
+
+#define REJECT_NUM      ( sizeof( g_afHz ) / sizeof( g_afHz[ 0 ] ) )
+
+static float g_fDuty;           // Window loop duty
+
+//----------------------------------------------------------------------------
+// FUNCTION : REJECT_Tick( bool bWindow )
+// PURPOSE  : Runs a control interval; for the window loop the duty is
+//            updated at the end of each QEI window and applied over the
+//            firmware's.
+//----------------------------------------------------------------------------
+
+static void REJECT_Tick( bool bWindow )
+{
+    SIM_Tick();
+
+    if( !bWindow ) return;
+
+    if( g_SIM.uiWinTicks == 0 )
+    {
+        g_fDuty += REJECT_KP * ( g_MCP.fSP - QEI_GetSpeed( g_MCP.pAxis ) );
+        g_fDuty = g_fDuty < 0.0f ? 0.0f : g_fDuty;
+        g_fDuty = g_fDuty > g_MCP.fDutyMax ? g_MCP.fDutyMax : g_fDuty;
+    }
+
+    g_MCP.fDuty = g_fDuty;
+    MOTOR_SetDutyCycle( &g_MCP, g_fDuty, g_MCP.bDir );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : REJECT_Run( bool bWindow, float fHz )
+// PURPOSE  : Returns |S| at a frequency for one loop.
+//----------------------------------------------------------------------------
+
+static float REJECT_Run( bool bWindow, float fHz )
+{
+    float fPeriod  = 1.0f / fHz;
+    uint32_t uiSettle = ( uint32_t )ceilf( REJECT_SETTLE / fPeriod );
+    uint32_t uiCycles = ( uint32_t )ceilf( REJECT_MEASURE / fPeriod );
+    uint32_t uiStart  = ( uint32_t )( ( uiSettle * fPeriod / MOTOR_CONTROL_DT ) + 0.5f );
+    uint32_t uiTicks  = ( uint32_t )( ( ( uiSettle + uiCycles ) * fPeriod / MOTOR_CONTROL_DT ) + 0.5f );
+    double dI = 0.0, dQ = 0.0;
+    uint32_t i;
+
+    SIM_Init();
+
+    g_SIM.fFric = REJECT_FRIC;
+    g_SIM.fLoad = REJECT_LOAD;
+    g_fDuty = 0.0f;
+
+    MOTOR_SetSetpoint( &g_MCP, REJECT_SP );
+
+    for( i = 0; i < ( uint32_t )( REJECT_SETTLE / MOTOR_CONTROL_DT ); i++ )
+    {
+        REJECT_Tick( bWindow );
+    }
+
+    for( i = 0; i < uiTicks; i++ )
+    {
+        double dPhase = 2.0 * M_PI * fHz * i * MOTOR_CONTROL_DT;
+
+        g_SIM.fLoad = REJECT_LOAD + ( REJECT_AMP * sin( dPhase ) );
+
+        REJECT_Tick( bWindow );
+
+        if( i < uiStart ) continue;
+
+        dI += g_SIM.fSpeed * sin( dPhase );
+        dQ += g_SIM.fSpeed * cos( dPhase );
+    }
+
+    double dN   = uiTicks - uiStart;
+    double dAmp = 2.0 * sqrt( ( dI * dI ) + ( dQ * dQ ) ) / dN;
+    double dW   = 2.0 * M_PI * fHz * g_SIM.fTau;
+    double dOL  = g_SIM.fKm * REJECT_AMP / sqrt( 1.0 + ( dW * dW ) );
+
+    return ( float )( dAmp / dOL );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : REJECT_Bandwidth( const float *pfS )
+// PURPOSE  : Returns the frequency where |S| first rises through -3 dB
+//            (log interpolation), or zero if below the first frequency.
+//----------------------------------------------------------------------------
+
+static float REJECT_Bandwidth( const float *pfS )
+{
+    uint32_t i;
+
+    if( pfS[ 0 ] >= REJECT_3DB ) return 0.0f;
+
+    for( i = 1; i < REJECT_NUM; i++ )
+    {
+        if( pfS[ i ] >= REJECT_3DB )
+        {
+            float fK = logf( REJECT_3DB / pfS[ i - 1 ] ) / logf( pfS[ i ] / pfS[ i - 1 ] );
+            return g_afHz[ i - 1 ] * powf( g_afHz[ i ] / g_afHz[ i - 1 ], fK );
+        }
+    }
+
+    return g_afHz[ REJECT_NUM - 1 ];
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    float afWin[ REJECT_NUM ];
+    float afFast[ REJECT_NUM ];
+    float fWinPeak = 0.0f;
+    float fFastPeak = 0.0f;
+    uint32_t i;
+
+    printf( "Load rejection |S| (speed response over the open loop response)\n" );
+    printf( "Hz       Window    1 kHz\n" );
+
+    for( i = 0; i < REJECT_NUM; i++ )
+    {
+        afWin[ i ]  = REJECT_Run( true, g_afHz[ i ] );
+        afFast[ i ] = REJECT_Run( false, g_afHz[ i ] );
+
+        printf( "%5.1f    %6.3f   %6.3f\n", g_afHz[ i ], afWin[ i ], afFast[ i ] );
+
+        if( afWin[ i ]  > fWinPeak )  fWinPeak  = afWin[ i ];
+        if( afFast[ i ] > fFastPeak ) fFastPeak = afFast[ i ];
+    }
+
+    float fWin  = REJECT_Bandwidth( afWin );
+    float fFast = REJECT_Bandwidth( afFast );
+
+    printf( "Rejection bandwidth (-3 dB): window %.2f Hz, 1 kHz %.2f Hz\n", fWin, fFast );
+    printf( "Peak |S|: window %.2f, 1 kHz %.2f\n", fWinPeak, fFastPeak );
+
+    HOST_CHECK( fFast > fWin );
+    HOST_CHECK( fFastPeak < fWinPeak );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_REJECT.C
+//----------------------------------------------------------------------------
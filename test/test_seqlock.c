@@ -0,0 +1,277 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_SEQLOCK.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Stress test of the published settings (MOTOR_Publish / MOTOR_Update).
+//
+// A writer stands in for the main loop and publishes sets whose four fields
+// all derive from one counter; a reader stands in for the control loop and
+// calls MOTOR_Update. Every applied set must be whole (its fields from the
+// same counter) and no older than the one before, and the last set must
+// land. The axis is g_MCP (axis 0), used without MOTOR_Init.
+//
+// Two readers are run:
+//
+//     Thread     a second thread calling MOTOR_Update as fast as it can,
+//                concurrently with the writer on a multi-core host (the
+//                plain volatile accesses rely on the store and load order
+//                of the target, which x86 also keeps)
+//     Interrupt  a 20 kHz timer signal interrupting the writer, as the
+//                control interrupt interrupts the main loop on the target;
+//                this one must land inside a publish at least once
+//
+// Each is run with the main loop owning the setpoint and again with the
+// reader holding it (as the sequencer does): the published setpoints must
+// then never reach fSP while the gains keep arriving whole.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "host.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define SEQLOCK_SETS     2000000    // Sets published per pass
+                                    // (n + 0.75 stays exact in a float)
+
+#define SEQLOCK_TICK     50         // Interrupt reader period (us)
+
+#define SEQLOCK_OWNED_SP -1.0f      // Setpoint held by the control loop owner
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+static volatile bool g_bDone;   // Writer finished
+static bool g_bOwned;           // Reader holds the setpoint this pass
+static float g_fLast;           // Counter of the last applied set
+
+static volatile uint32_t g_uiApplied;   // Sets applied by the reader
+static volatile uint32_t g_uiInside;    // Updates started part way through a publish
+static volatile uint32_t g_uiTorn;      // Sets applied with mixed fields
+static volatile uint32_t g_uiBackward;  // Sets older than the previous one
+static volatile uint32_t g_uiLeaked;    // Published setpoints applied while owned
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQLOCK_Writer( void *pArg )
+// PURPOSE  : Main loop stand-in.
+//----------------------------------------------------------------------------
+
+static void *SEQLOCK_Writer( void *pArg )
+{
+    MOTOR_SETTINGS sSet;
+    uint32_t n;
+
+    ( void )pArg;
+
+    for( n = 1; n <= SEQLOCK_SETS; n++ )
+    {
+        sSet.fSP = ( float )n;
+        sSet.fKP = ( float )n + 0.25f;
+        sSet.fKI = ( float )n + 0.5f;
+        sSet.fKD = ( float )n + 0.75f;
+        MOTOR_Publish( &g_MCP, &sSet );
+    }
+
+    g_bDone = true;
+
+    return NULL;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQLOCK_Tick( void )
+// PURPOSE  : One control loop update, checked.
+//----------------------------------------------------------------------------
+
+static void SEQLOCK_Tick( void )
+{
+    if( g_MCP.uiPubSeq & 1 ) g_uiInside++;
+
+    if( !MOTOR_Update( &g_MCP ) ) return;
+
+    g_uiApplied++;
+
+    float fBase = g_MCP.fKP - 0.25f;
+
+    if( ( g_MCP.fKI != fBase + 0.5f ) || ( g_MCP.fKD != fBase + 0.75f ) ) g_uiTorn++;
+    if( fBase < g_fLast ) g_uiBackward++;
+    g_fLast = fBase;
+
+    if( g_bOwned )
+    {
+        if( g_MCP.fSP != SEQLOCK_OWNED_SP ) g_uiLeaked++;
+    }
+    else if( g_MCP.fSP != fBase ) g_uiTorn++;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQLOCK_Reader( void *pArg )
+// PURPOSE  : Control loop stand-in (thread).
+//----------------------------------------------------------------------------
+
+static void *SEQLOCK_Reader( void *pArg )
+{
+    bool bDone;
+
+    ( void )pArg;
+
+    do
+    {
+        // Sampled before the update so that the last set is always seen
+        bDone = g_bDone;
+        SEQLOCK_Tick();
+
+    } while( !bDone );
+
+    return NULL;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQLOCK_Signal( int iSignal )
+// PURPOSE  : Control loop stand-in (interrupt).
+//----------------------------------------------------------------------------
+
+static void SEQLOCK_Signal( int iSignal )
+{
+    ( void )iSignal;
+
+    SEQLOCK_Tick();
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQLOCK_Timer( uint32_t uiPeriod )
+// PURPOSE  : Starts (period in us) or stops (0) the interrupt reader.
+//----------------------------------------------------------------------------
+
+static void SEQLOCK_Timer( uint32_t uiPeriod )
+{
+    struct itimerval sTimer;
+
+    sTimer.it_interval.tv_sec  = 0;
+    sTimer.it_interval.tv_usec = uiPeriod;
+    sTimer.it_value            = sTimer.it_interval;
+    setitimer( ITIMER_REAL, &sTimer, NULL );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : SEQLOCK_Pass( bool bThread, bool bOwned )
+// PURPOSE  : Runs the writer against one reader once.
+//----------------------------------------------------------------------------
+
+static void SEQLOCK_Pass( bool bThread, bool bOwned )
+{
+    pthread_t sWriter, sReader;
+    MOTOR_SETTINGS sSet;
+
+    g_MCP.uiOwner   = MOTOR_OWNER_MAIN;
+    g_MCP.uiPubSeq  = 0;
+    g_MCP.uiPubSeen = 0;
+    g_MCP.fSP = g_MCP.fKP = g_MCP.fKI = g_MCP.fKD = 0.0f;
+
+    g_bDone      = false;
+    g_bOwned     = bOwned;
+    g_fLast      = 0.0f;
+    g_uiApplied  = 0;
+    g_uiInside   = 0;
+    g_uiTorn     = 0;
+    g_uiBackward = 0;
+    g_uiLeaked   = 0;
+
+    // Claimed with the reader not yet running (the main loop with the
+    // control interrupt masked)
+    if( bOwned )
+    {
+        MOTOR_Claim( &g_MCP, MOTOR_OWNER_SEQ );
+        g_MCP.fSP = SEQLOCK_OWNED_SP;
+    }
+
+    if( bThread )
+    {
+        pthread_create( &sReader, NULL, SEQLOCK_Reader, NULL );
+        pthread_create( &sWriter, NULL, SEQLOCK_Writer, NULL );
+        pthread_join( sWriter, NULL );
+        pthread_join( sReader, NULL );
+    }
+    else
+    {
+        signal( SIGALRM, SEQLOCK_Signal );
+        SEQLOCK_Timer( SEQLOCK_TICK );
+        SEQLOCK_Writer( NULL );
+        SEQLOCK_Timer( 0 );
+
+        // The tick after the last publish
+        SEQLOCK_Tick();
+    }
+
+    if( bOwned ) MOTOR_Release( &g_MCP, MOTOR_OWNER_SEQ );
+
+    printf( "%s reader, %s setpoint: %lu applied, %lu inside a publish, "
+            "%lu torn, %lu out of order, %lu leaked\n",
+            bThread ? "Thread   " : "Interrupt", bOwned ? "owned" : "main ",
+            ( unsigned long )g_uiApplied, ( unsigned long )g_uiInside,
+            ( unsigned long )g_uiTorn, ( unsigned long )g_uiBackward,
+            ( unsigned long )g_uiLeaked );
+
+    HOST_CHECK( g_uiApplied > 0 );
+    HOST_CHECK( bThread || ( g_uiInside > 0 ) );
+    HOST_CHECK( g_uiTorn == 0 );
+    HOST_CHECK( g_uiBackward == 0 );
+    HOST_CHECK( g_uiLeaked == 0 );
+
+    // The last set always lands
+    HOST_CHECK( g_MCP.fKP == ( float )SEQLOCK_SETS + 0.25f );
+
+    // Release leaves the owner's setpoint published
+    MOTOR_GetSettings( &g_MCP, &sSet );
+    HOST_CHECK( sSet.fSP == ( bOwned ? SEQLOCK_OWNED_SP : ( float )SEQLOCK_SETS ) );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    printf( "%lu sets published per pass\n", ( unsigned long )SEQLOCK_SETS );
+
+    SEQLOCK_Pass( true,  false );
+    SEQLOCK_Pass( true,  true );
+    SEQLOCK_Pass( false, false );
+    SEQLOCK_Pass( false, true );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_SEQLOCK.C
+//----------------------------------------------------------------------------
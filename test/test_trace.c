@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TEST_TRACE.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Host check of the control loop timing instrumentation (trace.c).
+//
+// A 1 kHz loop (absolute sleeps) stands in for the control interrupt with a
+// fixed busy body, traced as the handler is. The histograms must hold every
+// tick and the execution time must cover the body. The period jitter is
+// the host scheduler's, so it is printed but not judged.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <time.h>
+
+#include "host.h"
+#include "trace.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define TRACE_TICKS     2000    // Control intervals traced
+#define TRACE_BODY      100     // Handler body (us)
+#define TRACE_OUTPUT    20      // Entry to the PWM update (us)
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Busy( uint32_t uiMicros )
+// PURPOSE  : Spins for a time (us).
+//----------------------------------------------------------------------------
+
+static void TRACE_Busy( uint32_t uiMicros )
+{
+    struct timespec sStart, sNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &sStart );
+
+    do
+    {
+        clock_gettime( CLOCK_MONOTONIC, &sNow );
+
+    } while( ( ( ( sNow.tv_sec - sStart.tv_sec ) * 1000000000L )
+               + ( sNow.tv_nsec - sStart.tv_nsec ) ) < ( uiMicros * 1000L ) );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : main( void )
+// PURPOSE  : Test entry.
+//----------------------------------------------------------------------------
+
+int main( void )
+{
+    extern TRACE_PARAMS g_TRACE;
+    struct timespec sWake;
+    uint32_t i;
+
+    TRACE_Init( 0.001f );
+    HOST_CHECK( g_TRACE.uiPeriod == 1000 * TRACE_CLOCK );
+
+    clock_gettime( CLOCK_MONOTONIC, &sWake );
+
+    for( i = 0; i < TRACE_TICKS; i++ )
+    {
+        sWake.tv_nsec += 1000000;
+        if( sWake.tv_nsec >= 1000000000 )
+        {
+            sWake.tv_nsec -= 1000000000;
+            sWake.tv_sec++;
+        }
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &sWake, NULL );
+
+        TRACE_Enter();
+        TRACE_Busy( TRACE_OUTPUT );
+        TRACE_Output();
+        TRACE_Busy( TRACE_BODY - TRACE_OUTPUT );
+        TRACE_Exit();
+    }
+
+    HOST_CHECK( g_TRACE.sJitter.uiCount == TRACE_TICKS - 1 );
+    HOST_CHECK( g_TRACE.sExec.uiCount == TRACE_TICKS );
+    HOST_CHECK( g_TRACE.sLatency.uiCount == TRACE_TICKS );
+
+    // Nothing shorter than the body (5 us execution bins)
+    HOST_CHECK( g_TRACE.sExec.uiMax >= TRACE_BODY * TRACE_CLOCK );
+    HOST_CHECK( g_TRACE.sLatency.uiMax >= TRACE_OUTPUT * TRACE_CLOCK );
+    for( i = 0; i < ( TRACE_BODY / 5 ) - 1; i++ ) HOST_CHECK( g_TRACE.sExec.auBin[ i ] == 0 );
+
+    TRACE_Dump();
+
+    // The next entry starts afresh
+    TRACE_Enter();
+    HOST_CHECK( !g_TRACE.bReset );
+    HOST_CHECK( g_TRACE.sExec.uiCount == 0 );
+    HOST_CHECK( g_TRACE.uiMissed == 0 );
+
+    return HOST_Result();
+}
+
+//----------------------------------------------------------------------------
+// END TEST_TRACE.C
+//----------------------------------------------------------------------------
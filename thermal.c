@@ -0,0 +1,108 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : THERMAL.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Motor thermal model and duty derating.
+//
+// The winding is modelled as a single thermal mass above ambient. The
+// losses are taken as proportional to the square of the applied duty
+// (current roughly follows duty), so the steady-state rise is:
+//
+//     Rise = THERMAL_RISE * Duty^2
+//
+// and the estimate follows it with the winding time constant:
+//
+//     Rise[k+1] = Rise[k] + ( dt / Tau ) * ( THERMAL_RISE * Duty^2 - Rise[k] )
+//
+// Above THERMAL_START the duty ceiling is lowered linearly to THERMAL_MIN
+// at THERMAL_END. The ceiling only rises again once the winding has cooled
+// THERMAL_HYST below the temperature that set it.
+//
+// Called from the main loop at the ADC rate with the AIN5 ambient reading.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "thermal.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+THERMAL_PARAMS g_aTHM[ MOTOR_NUM_AXES ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : THERMAL_Ceiling( float fWinding )
+// PURPOSE  : Duty ceiling for a winding temperature (C).
+//----------------------------------------------------------------------------
+
+static float THERMAL_Ceiling( float fWinding )
+{
+    if( fWinding <= THERMAL_START ) return MOTOR_DUTY_MAX;
+    if( fWinding >= THERMAL_END )   return THERMAL_MIN;
+
+    return MOTOR_DUTY_MAX - ( ( MOTOR_DUTY_MAX - THERMAL_MIN )
+                            * ( fWinding - THERMAL_START ) / ( THERMAL_END - THERMAL_START ) );
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : THERMAL_Init( THERMAL_PARAMS *pTHM, float fdt )
+// PURPOSE  : Thermal model initialization. fdt is the update interval (s).
+//----------------------------------------------------------------------------
+
+void THERMAL_Init( THERMAL_PARAMS *pTHM, float fdt )
+{
+    pTHM->fA       = fdt / THERMAL_TAU;
+    pTHM->fAmbient = 25.0f;
+    pTHM->fRise    = 0.0f;
+    pTHM->fWinding = pTHM->fAmbient;
+    pTHM->fLimit   = MOTOR_DUTY_MAX;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : THERMAL_Update( THERMAL_PARAMS *pTHM, MOTOR_CONTROL_PARAMS *pMCP,
+//                            float fAmbient )
+// PURPOSE  : Advances the model one interval and derates the duty ceiling.
+//----------------------------------------------------------------------------
+
+void THERMAL_Update( THERMAL_PARAMS *pTHM, MOTOR_CONTROL_PARAMS *pMCP, float fAmbient )
+{
+    float fDuty = pMCP->fDuty;
+
+    pTHM->fAmbient = fAmbient;
+    pTHM->fRise   += pTHM->fA * ( ( THERMAL_RISE * fDuty * fDuty ) - pTHM->fRise );
+    pTHM->fWinding = fAmbient + pTHM->fRise;
+
+    // Falling ceilings apply at once, rising ones only after cooling
+    float fLimit = THERMAL_Ceiling( pTHM->fWinding );
+    if( fLimit > pTHM->fLimit )
+    {
+        fLimit = THERMAL_Ceiling( pTHM->fWinding + THERMAL_HYST );
+        if( fLimit < pTHM->fLimit ) fLimit = pTHM->fLimit;
+    }
+    pTHM->fLimit = fLimit;
+
+    // Single word write; picked up by the control loop on its next tick
+    pMCP->fDutyMax = fLimit;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END THERMAL.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : THERMAL.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef THERMAL_H_
+#define THERMAL_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+#include "motor.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define THERMAL_DT      0.1f    // Update interval (ADC conversion interval, s)
+
+#define THERMAL_TAU     120.0f  // Winding to ambient time constant (s)
+#define THERMAL_RISE    80.0f   // Steady-state winding rise at 100% duty (C)
+
+#define THERMAL_START   85.0f   // Winding temperature where derating starts (C)
+#define THERMAL_END     110.0f  // Winding temperature of the minimum ceiling (C)
+#define THERMAL_MIN     0.2f    // Minimum duty ceiling
+#define THERMAL_HYST    5.0f    // Cooling required before the ceiling rises (C)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagTHERMAL_PARAMS
+{
+    float fA;           // dt / Tau
+    float fAmbient;     // Ambient temperature (C)
+    float fRise;        // Estimated winding rise above ambient (C)
+    float fWinding;     // Estimated winding temperature (C)
+    float fLimit;       // Duty ceiling (0.0 to MOTOR_DUTY_MAX)
+
+} THERMAL_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void THERMAL_Init( THERMAL_PARAMS *pTHM, float fdt );
+void THERMAL_Update( THERMAL_PARAMS *pTHM, MOTOR_CONTROL_PARAMS *pMCP, float fAmbient );
+
+#endif // THERMAL_H_
+
+//----------------------------------------------------------------------------
+// END THERMAL.H
+//----------------------------------------------------------------------------
@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TIMER.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+
+//----------------------------------------------------------------------------
+// MACROS
+//----------------------------------------------------------------------------
+
+#define TIMER0A_IntEnable()  ( HWREG( NVIC_EN0  ) = ( 1 << 19 ) )
+#define TIMER0A_IntDisable() ( HWREG( NVIC_DIS0 ) = ( 1 << 19 ) )
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void TIMER_Init( float fdt );
+
+#endif // TIMER_H_
+
+//----------------------------------------------------------------------------
+// END TIMER.H
+//----------------------------------------------------------------------------
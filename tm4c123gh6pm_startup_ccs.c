@@ -37,6 +37,13 @@ static void IntDefaultHandler(void);
 void ADC_SS0_IntHandler( void );
 void I2C0_IntHandler( void );
 void QEI0_IntHandler( void );
+void TIMER0A_IntHandler( void );
+void QEI1_IntHandler( void );
+void PWM0_FAULT_IntHandler( void );
+void PWM0_GEN0_IntHandler( void );
+void PWM0_GEN1_IntHandler( void );
+void WTIMER0A_IntHandler( void );
+void ADC1_SS1_IntHandler( void );
 
 //*****************************************************************************
 //
@@ -100,9 +107,9 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     I2C0_IntHandler,                      // I2C0 Master and Slave
-    IntDefaultHandler,                      // PWM Fault
-    IntDefaultHandler,                      // PWM Generator 0
-    IntDefaultHandler,                      // PWM Generator 1
+    PWM0_FAULT_IntHandler,                      // PWM Fault
+    PWM0_GEN0_IntHandler,                   // PWM Generator 0
+    PWM0_GEN1_IntHandler,                   // PWM Generator 1
     IntDefaultHandler,                      // PWM Generator 2
     QEI0_IntHandler,                      // Quadrature Encoder 0
     ADC_SS0_IntHandler,                      // ADC Sequence 0
@@ -110,7 +117,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // ADC Sequence 2
     IntDefaultHandler,                      // ADC Sequence 3
     IntDefaultHandler,                      // Watchdog timer
-    IntDefaultHandler,                      // Timer 0 subtimer A
+    TIMER0A_IntHandler,                      // Timer 0 subtimer A
     IntDefaultHandler,                      // Timer 0 subtimer B
     IntDefaultHandler,                      // Timer 1 subtimer A
     IntDefaultHandler,                      // Timer 1 subtimer B
@@ -129,7 +136,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // Timer 3 subtimer A
     IntDefaultHandler,                      // Timer 3 subtimer B
     IntDefaultHandler,                      // I2C1 Master and Slave
-    IntDefaultHandler,                      // Quadrature Encoder 1
+    QEI1_IntHandler,                      // Quadrature Encoder 1
     IntDefaultHandler,                      // CAN0
     IntDefaultHandler,                      // CAN1
     0,                                      // Reserved
@@ -140,7 +147,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // uDMA Software Transfer
     IntDefaultHandler,                      // uDMA Error
     IntDefaultHandler,                      // ADC1 Sequence 0
-    IntDefaultHandler,                      // ADC1 Sequence 1
+    ADC1_SS1_IntHandler,                    // ADC1 Sequence 1
     IntDefaultHandler,                      // ADC1 Sequence 2
     IntDefaultHandler,                      // ADC1 Sequence 3
     0,                                      // Reserved
@@ -185,7 +192,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     IntDefaultHandler,                      // Timer 5 subtimer A
     IntDefaultHandler,                      // Timer 5 subtimer B
-    IntDefaultHandler,                      // Wide Timer 0 subtimer A
+    WTIMER0A_IntHandler,                    // Wide Timer 0 subtimer A
     IntDefaultHandler,                      // Wide Timer 0 subtimer B
     IntDefaultHandler,                      // Wide Timer 1 subtimer A
     IntDefaultHandler,                      // Wide Timer 1 subtimer B
@@ -0,0 +1,276 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TRACE.C
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// MODULE DESCRIPTION
+//----------------------------------------------------------------------------
+//
+// Control loop timing instrumentation.
+//
+// The control interrupt (Timer 0A) timestamps its entry, its first PWM
+// update and its exit against the DWT cycle counter (free running at the
+// system clock). Three fixed-size histograms are kept:
+//
+//     Jitter   | entry to entry period - nominal period |
+//     Exec     entry to exit
+//     Latency  timer time-out to the axis 0 PWM update (the time already
+//              elapsed on the timer at entry plus entry to update)
+//
+// A period over 1.5 times nominal counts as missed, and a time-out still
+// pending at exit (the handler outlasted the period) as an overrun.
+//
+// The host build (HOST_BUILD, see test/) counts CLOCK_MONOTONIC instead,
+// scaled to the same cycles. It has no timer to read, so the latency is
+// entry to update only and an overrun is a handler longer than the period.
+//
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#ifdef HOST_BUILD
+#include <time.h>
+#endif
+
+#include "trace.h"
+#include "uart.h"
+
+//----------------------------------------------------------------------------
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------
+
+TRACE_PARAMS g_TRACE;
+
+static char g_sTraceBuffer[ 80 ];
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Now( void )
+// PURPOSE  : Returns the cycle count (wraps at 32 bits).
+//----------------------------------------------------------------------------
+
+static uint32_t TRACE_Now( void )
+{
+#ifdef HOST_BUILD
+    struct timespec sNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &sNow );
+
+    return ( uint32_t )( ( ( ( uint64_t )sNow.tv_sec * 1000000000u ) + sNow.tv_nsec )
+                         * TRACE_CLOCK / 1000u );
+#else
+    return HWREG( DWT_CYCCNT );
+#endif
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_HistClear( TRACE_HIST *pHist, uint32_t uiWidth )
+// PURPOSE  : Empties a histogram.
+//----------------------------------------------------------------------------
+
+static void TRACE_HistClear( TRACE_HIST *pHist, uint32_t uiWidth )
+{
+    uint8_t i;
+
+    for( i = 0; i < TRACE_BINS; i++ ) pHist->auBin[ i ] = 0;
+
+    pHist->uiWidth = uiWidth;
+    pHist->uiMax   = 0;
+    pHist->uiCount = 0;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_HistAdd( TRACE_HIST *pHist, uint32_t uiValue )
+// PURPOSE  : Records a value (cycles).
+//----------------------------------------------------------------------------
+
+static void TRACE_HistAdd( TRACE_HIST *pHist, uint32_t uiValue )
+{
+    uint32_t uiBin = uiValue / pHist->uiWidth;
+
+    pHist->auBin[ uiBin < TRACE_BINS ? uiBin : TRACE_BINS - 1 ]++;
+    pHist->uiCount++;
+    if( uiValue > pHist->uiMax ) pHist->uiMax = uiValue;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Reset( void )
+// PURPOSE  : Clears all statistics (control loop).
+//----------------------------------------------------------------------------
+
+static void TRACE_Reset( void )
+{
+    TRACE_HistClear( &g_TRACE.sJitter,  1 * TRACE_CLOCK ); // 1 us bins
+    TRACE_HistClear( &g_TRACE.sExec,    5 * TRACE_CLOCK ); // 5 us bins
+    TRACE_HistClear( &g_TRACE.sLatency, 5 * TRACE_CLOCK ); // 5 us bins
+
+    g_TRACE.uiMissed   = 0;
+    g_TRACE.uiOverruns = 0;
+    g_TRACE.bFirst     = true;
+    g_TRACE.bReset     = false;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Init( float fdt )
+// PURPOSE  : Starts the cycle counter. fdt is the control interval (s).
+//----------------------------------------------------------------------------
+
+void TRACE_Init( float fdt )
+{
+#ifndef HOST_BUILD
+    // Enable the DWT (TRCENA) and its cycle counter
+    HWREG( NVIC_DEMCR ) |= ( 1 << 24 );
+    HWREG( DWT_CYCCNT ) = 0;
+    HWREG( DWT_CTRL )   |= ( 1 << 0 );
+#endif
+
+    g_TRACE.uiPeriod = ( uint32_t )( ( fdt * TRACE_CLOCK * 1000000.0f ) + 0.5f );
+
+    TRACE_Reset();
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Enter( void )
+// PURPOSE  : Control interrupt entry (first statement of the handler).
+//----------------------------------------------------------------------------
+
+void TRACE_Enter( void )
+{
+    uint32_t uiNow = TRACE_Now();
+
+    // Time already elapsed since the time-out (down counter)
+#ifdef HOST_BUILD
+    g_TRACE.uiLate = 0;
+#else
+    g_TRACE.uiLate = HWREG( TIMER0_BASE + TIMER_O_TAILR ) - HWREG( TIMER0_BASE + TIMER_O_TAR );
+#endif
+
+    if( g_TRACE.bReset ) TRACE_Reset();
+
+    if( !g_TRACE.bFirst )
+    {
+        uint32_t uiPeriod = uiNow - g_TRACE.uiLast;
+
+        TRACE_HistAdd( &g_TRACE.sJitter, uiPeriod > g_TRACE.uiPeriod ? uiPeriod - g_TRACE.uiPeriod
+                                                                     : g_TRACE.uiPeriod - uiPeriod );
+
+        if( uiPeriod > ( g_TRACE.uiPeriod + ( g_TRACE.uiPeriod / 2 ) ) ) g_TRACE.uiMissed++;
+    }
+
+    g_TRACE.bFirst  = false;
+    g_TRACE.uiLast  = uiNow;
+    g_TRACE.uiEntry = uiNow;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Output( void )
+// PURPOSE  : Axis 0 PWM update done.
+//----------------------------------------------------------------------------
+
+void TRACE_Output( void )
+{
+    TRACE_HistAdd( &g_TRACE.sLatency, g_TRACE.uiLate + ( TRACE_Now() - g_TRACE.uiEntry ) );
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Exit( void )
+// PURPOSE  : Control interrupt exit (last statement of the handler).
+//----------------------------------------------------------------------------
+
+void TRACE_Exit( void )
+{
+    uint32_t uiExec = TRACE_Now() - g_TRACE.uiEntry;
+
+    TRACE_HistAdd( &g_TRACE.sExec, uiExec );
+
+    // Another time-out while running
+#ifdef HOST_BUILD
+    if( uiExec > g_TRACE.uiPeriod ) g_TRACE.uiOverruns++;
+#else
+    if( HWREG( TIMER0_BASE + TIMER_O_RIS ) & ( 1 << 0 ) ) g_TRACE.uiOverruns++;
+#endif
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_DumpHist( char *sName, TRACE_HIST *pHist )
+// PURPOSE  : Sends a histogram over the UART (non-empty bins only).
+//----------------------------------------------------------------------------
+
+static void TRACE_DumpHist( char *sName, TRACE_HIST *pHist )
+{
+    uint8_t i;
+    uint32_t uiWidth = pHist->uiWidth / TRACE_CLOCK;
+
+    sprintf( g_sTraceBuffer, "%s: n=%lu max=%lu.%02lu us\r\n", sName,
+             ( unsigned long )pHist->uiCount,
+             ( unsigned long )( pHist->uiMax / TRACE_CLOCK ),
+             ( unsigned long )( ( ( pHist->uiMax % TRACE_CLOCK ) * 100 ) / TRACE_CLOCK ) );
+    UART_SendMessage( g_sTraceBuffer );
+
+    for( i = 0; i < TRACE_BINS; i++ )
+    {
+        if( !pHist->auBin[ i ] ) continue;
+
+        if( i < TRACE_BINS - 1 )
+        {
+            sprintf( g_sTraceBuffer, "  %4lu-%4lu us %lu\r\n",
+                     ( unsigned long )( i * uiWidth ), ( unsigned long )( ( i + 1 ) * uiWidth ),
+                     ( unsigned long )pHist->auBin[ i ] );
+        }
+        else
+        {
+            sprintf( g_sTraceBuffer, "  %4lu+     us %lu\r\n",
+                     ( unsigned long )( i * uiWidth ), ( unsigned long )pHist->auBin[ i ] );
+        }
+        UART_SendMessage( g_sTraceBuffer );
+    }
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// FUNCTION : TRACE_Dump( void )
+// PURPOSE  : Sends the statistics over the UART and restarts them (main loop).
+//----------------------------------------------------------------------------
+
+void TRACE_Dump( void )
+{
+    TRACE_DumpHist( "Period jitter", &g_TRACE.sJitter );
+    TRACE_DumpHist( "ISR execution", &g_TRACE.sExec );
+    TRACE_DumpHist( "PWM latency",   &g_TRACE.sLatency );
+
+    sprintf( g_sTraceBuffer, "Missed periods %lu, overruns %lu\r\n",
+             ( unsigned long )g_TRACE.uiMissed, ( unsigned long )g_TRACE.uiOverruns );
+    UART_SendMessage( g_sTraceBuffer );
+
+    // Cleared by the control loop on its next entry
+    g_TRACE.bReset = true;
+
+    return;
+}
+
+//----------------------------------------------------------------------------
+// END TRACE.C
+//----------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------
+// COMPANY      : Confederation College
+// FILE         : TRACE.H
+// FILE VERSION : 1.0
+// PROGRAMMER   : Selumala
+//----------------------------------------------------------------------------
+// REVISION HISTORY
+//----------------------------------------------------------------------------
+//
+// 1.0, 2026-10-19, Selumala
+//   - Initial release
+//
+//----------------------------------------------------------------------------
+// INCLUSION LOCK
+//----------------------------------------------------------------------------
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+//----------------------------------------------------------------------------
+// INCLUDE FILES
+//----------------------------------------------------------------------------
+
+#include "global.h"
+
+//----------------------------------------------------------------------------
+// CONSTANTS
+//----------------------------------------------------------------------------
+
+#define TRACE_BINS      32      // Bins per histogram (the last one is overflow)
+
+#define TRACE_CLOCK     80      // Cycles per microsecond (80 MHz)
+
+//----------------------------------------------------------------------------
+// STRUCTURES
+//----------------------------------------------------------------------------
+
+typedef struct tagTRACE_HIST
+{
+    uint32_t auBin[ TRACE_BINS ];   // Counts
+    uint32_t uiWidth;               // Bin width (cycles)
+    uint32_t uiMax;                 // Largest value seen (cycles)
+    uint32_t uiCount;               // Values recorded
+
+} TRACE_HIST;
+
+typedef struct tagTRACE_PARAMS
+{
+    uint32_t uiPeriod;      // Nominal control period (cycles)
+    uint32_t uiLast;        // Cycle count at the previous entry
+    uint32_t uiEntry;       // Cycle count at this entry
+    uint32_t uiLate;        // Timer time-out to entry (cycles)
+    bool     bFirst;        // No previous entry yet
+
+    TRACE_HIST sJitter;     // |Period - nominal|
+    TRACE_HIST sExec;       // Entry to exit
+    TRACE_HIST sLatency;    // Timer time-out to PWM update (axis 0)
+
+    uint32_t uiMissed;      // Periods longer than 1.5 nominal
+    uint32_t uiOverruns;    // Time-outs while the handler was still running
+
+    volatile bool bReset;   // Clear on the next entry (set by the main loop)
+
+} TRACE_PARAMS;
+
+//----------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//----------------------------------------------------------------------------
+
+void TRACE_Init( float fdt );
+void TRACE_Enter( void );
+void TRACE_Output( void );
+void TRACE_Exit( void );
+void TRACE_Dump( void );
+
+#endif // TRACE_H_
+
+//----------------------------------------------------------------------------
+// END TRACE.H
+//----------------------------------------------------------------------------
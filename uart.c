@@ -27,6 +27,16 @@
 #include "motor.h"
 #include "qei.h"
 #include "led.h"
+#include "position.h"
+#include "fault.h"
+#include "current.h"
+#include "thermal.h"
+#include "ilc.h"
+#include "seq.h"
+#include "observer.h"
+#include "trace.h"
+#include "step.h"
+#include "fric.h"
 
 
 //----------------------------------------------------------------------------
@@ -37,7 +47,15 @@ QUEUE *g_pQueueTransmit;
 QUEUE *g_pQueueReceive;
 char g_sUARTBuffer[80];
 uint8_t g_aRTCData[8];
-extern MOTOR_CONTROL_PARAMS g_MCP;
+extern POSITION_PARAMS g_aPOS[ MOTOR_NUM_AXES ];
+extern FAULT_PARAMS g_aFLT[ MOTOR_NUM_AXES ];
+extern CURRENT_PARAMS g_CUR;
+extern THERMAL_PARAMS g_aTHM[ MOTOR_NUM_AXES ];
+extern ILC_PARAMS g_aILC[ MOTOR_NUM_AXES ];
+extern STEP_PARAMS g_aSTEP[ MOTOR_NUM_AXES ];
+extern FRIC_PARAMS g_aFRIC[ MOTOR_NUM_AXES ];
+extern SEQ_PARAMS g_SEQ;
+extern OBSERVER_PARAMS g_aOBS[ MOTOR_NUM_AXES ];
 
 
 enum
@@ -265,7 +283,21 @@ void UART_Init(void)
 
 void  UART_ReadChar(uint8_t uiData, float *UART_SS0Read)
 {
-
+    // Binary recipe upload in progress (the bytes are not commands)
+    switch (SEQ_Receive(&g_SEQ, uiData))
+    {
+    case SEQ_RX_IDLE:
+        break;
+    case SEQ_RX_DONE:
+        sprintf(g_sUARTBuffer, "Recipe loaded (%u segments)\r\n", g_SEQ.uiNumSeg);
+        UART_SendMessage(g_sUARTBuffer);
+        return;
+    case SEQ_RX_ERROR:
+        UART_SendMessage("Recipe upload rejected\r\n");
+        return;
+    default:
+        return;
+    }
 
     switch ((char) uiData)
     {
@@ -368,8 +400,7 @@ void  UART_ReadChar(uint8_t uiData, float *UART_SS0Read)
     {
         UART_SendMessage("\e[K");
         UART_SendMessage("Speed :"); // Display Kelvin
-        g_MCP.fSP =QEI_GetSpeed();
-        sprintf(g_sUARTBuffer, "%5.1f", g_MCP.fSP);
+        sprintf(g_sUARTBuffer, "%5.1f", QEI_GetVelocity(g_MCP.pAxis));
         UART_SendMessage(g_sUARTBuffer);
         UART_SendMessage("RPM\r\n");
         UART_SendMessage("\e(B");  // ASCII
@@ -377,6 +408,188 @@ void  UART_ReadChar(uint8_t uiData, float *UART_SS0Read)
 
         break;
     }
+    case '>':
+    case '<':
+    {
+        UART_SendMessage("\e[K");
+        if (POSITION_MoveBy(&g_aPOS[0], POSITION_DegreesToCounts(&g_aPOS[0],
+                (char) uiData == '>' ? 90.0f : -90.0f)))
+        {
+            UART_SendMessage((char) uiData == '>' ? "Move by +90.0 deg\r\n"
+                                                  : "Move by -90.0 deg\r\n");
+        }
+        else
+        {
+            UART_SendMessage("Recipe running - E to stop it first\r\n");
+        }
+        break;
+    }
+    case 'Z':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage(POSITION_MoveTo(&g_aPOS[0], 0)
+                ? "Move to 0.0 deg\r\n"
+                : "Recipe running - E to stop it first\r\n");
+        break;
+    }
+    case 'P':
+    {
+        UART_SendMessage("\e[K");
+        sprintf(g_sUARTBuffer, "Position : %7.1f deg (target %7.1f deg)\r\n",
+                POSITION_CountsToDegrees(&g_aPOS[0], g_aPOS[0].iPos),
+                POSITION_CountsToDegrees(&g_aPOS[0], (int32_t) g_aPOS[0].fRef));
+        UART_SendMessage(g_sUARTBuffer);
+        sprintf(g_sUARTBuffer, "Absolute : %.1f deg (%.3f rev) from %s%s\r\n",
+                POSITION_GetDegrees(&g_aPOS[0]),
+                POSITION_GetDegrees(&g_aPOS[0]) / 360.0,
+                g_aPOS[0].sAbs.bHomed ? "home" : "power up",
+                g_aPOS[0].sAbs.bHomeReq ? " (homing)" : "");
+        UART_SendMessage(g_sUARTBuffer);
+        break;
+    }
+    case 'N':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage(QEI_USE_INDEX ? "Homing on the next index pulse\r\n"
+                                       : "Home set to the present position\r\n");
+        POSITION_Home(&g_aPOS[0]);
+        break;
+    }
+    case 'D':
+    {
+        UART_SendMessage("\e[K");
+        MOTOR_SetDirection(&g_MCP, !g_MCP.bDirCmd);
+        sprintf(g_sUARTBuffer, "Direction : %s (last reversal %5.3f s)\r\n",
+                g_MCP.bDirCmd ? "FWD" : "REV", g_MCP.fRevTime);
+        UART_SendMessage(g_sUARTBuffer);
+        break;
+    }
+    case 'X':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage("Motor fault cleared (speed set to 0.0 RPM)\r\n");
+        POSITION_Stop(&g_aPOS[0]);
+        CURRENT_Clear(&g_CUR);
+        FAULT_Clear(&g_aFLT[0], &g_MCP);
+        break;
+    }
+    case 'S':
+    {
+        UART_SendMessage("\e[K");
+        sprintf(g_sUARTBuffer, "Thermal : ambient %5.1f C, winding %5.1f C, duty ceiling %3.0f%%\r\n",
+                g_aTHM[0].fAmbient, g_aTHM[0].fWinding, g_aTHM[0].fLimit * 100.0f);
+        UART_SendMessage(g_sUARTBuffer);
+        sprintf(g_sUARTBuffer, "Load : %5.1f%% duty (speed %5.1f RPM, duty %5.1f%%)\r\n",
+                g_aOBS[0].fDist * 100.0f, g_aOBS[0].fSpeed, g_MCP.fDuty * 100.0f);
+        UART_SendMessage(g_sUARTBuffer);
+        sprintf(g_sUARTBuffer, "Brake : %s, last %4.2f s from %5.1f RPM\r\n",
+                g_MCP.bBraking ? "braking" : "off", g_MCP.fBrakeTime, g_MCP.fBrakeFrom);
+        UART_SendMessage(g_sUARTBuffer);
+        break;
+    }
+    case 'W':
+    {
+        UART_SendMessage("\e[K");
+        if (g_aILC[0].bEnabled)
+        {
+            ILC_Stop(&g_aILC[0]);
+            UART_SendMessage("Iterative learning off\r\n");
+        }
+        else
+        {
+            ILC_Start(&g_aILC[0], ILC_PERIOD, g_MCP.fdt);
+            sprintf(g_sUARTBuffer, "Iterative learning on (%3.1f s cycle from now)\r\n",
+                    ILC_PERIOD);
+            UART_SendMessage(g_sUARTBuffer);
+        }
+        break;
+    }
+    case 'G':
+    {
+        UART_SendMessage("\e[K");
+        if (g_MCP.uiOwner == MOTOR_OWNER_POSITION)
+        {
+            UART_SendMessage("Position mode - V to leave it first\r\n");
+            break;
+        }
+        UART_SendMessage(g_SEQ.uiState == SEQ_PAUSE ? "Recipe resumed\r\n"
+                                                    : "Recipe started\r\n");
+        SEQ_Start(&g_SEQ);
+        break;
+    }
+    case 'H':
+    {
+        UART_SendMessage("\e[K");
+        sprintf(g_sUARTBuffer, "Recipe paused at segment %u\r\n", g_SEQ.uiSeg);
+        UART_SendMessage(g_sUARTBuffer);
+        SEQ_Pause(&g_SEQ);
+        break;
+    }
+    case 'E':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage("Recipe stopped (speed set to 0.0 RPM)\r\n");
+        SEQ_Stop(&g_SEQ);
+        break;
+    }
+    case 'U':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage("Send recipe: count, count x 8 bytes, checksum\r\n");
+        SEQ_Upload(&g_SEQ);
+        break;
+    }
+    case 'J':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage("Control loop timing (since the last dump)\r\n");
+        TRACE_Dump();
+        break;
+    }
+    case 'K':
+    {
+        uint8_t uiAxis;
+
+        UART_SendMessage("\e[K");
+        for (uiAxis = 0; uiAxis < MOTOR_NUM_AXES; uiAxis++)
+        {
+            STEP_List(&g_aSTEP[uiAxis], uiAxis);
+        }
+        break;
+    }
+    case 'B':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage("Calibrating friction (speed set to 0.0 RPM)\r\n");
+        POSITION_Stop(&g_aPOS[0]);
+        MOTOR_SetSetpoint(&g_MCP, 0.0f);
+        FRIC_Start(&g_aFRIC[0]);
+        break;
+    }
+    case 'O':
+    {
+        UART_SendMessage("\e[K");
+        sprintf(g_sUARTBuffer, "Current : %4.2f A (I2t %4.2f of %4.2f A2s)\r\n",
+                g_CUR.fCurrent, g_CUR.fI2t, CURRENT_I2T);
+        UART_SendMessage(g_sUARTBuffer);
+        if (g_CUR.uiTrips)
+        {
+            sprintf(g_sUARTBuffer, "Trips : %lu, last %s at %lu ms (%4.2f A, %4.2f A2s)\r\n",
+                    (unsigned long) g_CUR.uiTrips,
+                    g_CUR.sTrip.uiCause == FAULT_I2T ? "I2T" : "OVERCURRENT",
+                    (unsigned long) g_CUR.sTrip.uiTick,
+                    g_CUR.sTrip.fCurrent, g_CUR.sTrip.fI2t);
+            UART_SendMessage(g_sUARTBuffer);
+        }
+        break;
+    }
+    case 'V':
+    {
+        UART_SendMessage("\e[K");
+        UART_SendMessage("Position mode off (speed control)\r\n");
+        POSITION_Stop(&g_aPOS[0]);
+        break;
+    }
     case '?':
     {
 
@@ -393,6 +606,21 @@ void  UART_ReadChar(uint8_t uiData, float *UART_SS0Read)
         UART_SendMessage("M - Change the mode of control to manual\r\n");
         UART_SendMessage("I - Display system information\r\n");
         UART_SendMessage("L - Toggles the state of LED3\r\n");
+        UART_SendMessage("<,> - Move the output shaft by -/+90 degrees\r\n");
+        UART_SendMessage("Z - Move the output shaft to 0 degrees\r\n");
+        UART_SendMessage("P - Display the output shaft position\r\n");
+        UART_SendMessage("N - Home the output shaft position\r\n");
+        UART_SendMessage("V - Leave position mode (speed control)\r\n");
+        UART_SendMessage("D - Reverse the direction of the motor\r\n");
+        UART_SendMessage("X - Clear a motor fault\r\n");
+        UART_SendMessage("O - Display the motor current and last trip\r\n");
+        UART_SendMessage("S - Display the motor thermal model and load estimate\r\n");
+        UART_SendMessage("W - Start/stop iterative learning of the speed cycle\r\n");
+        UART_SendMessage("G,H,E - Start (resume), pause, stop the recipe\r\n");
+        UART_SendMessage("U - Upload a recipe (binary)\r\n");
+        UART_SendMessage("J - Display the control loop timing histograms\r\n");
+        UART_SendMessage("K - List the last step response results\r\n");
+        UART_SendMessage("B - Calibrate the breakaway friction\r\n");
         UART_SendMessage("\n");
         UART_SendMessage("<Ctrl>+R-Reset the embedded system\r\n");
 
@@ -402,7 +630,7 @@ void  UART_ReadChar(uint8_t uiData, float *UART_SS0Read)
            {
                UART_SendMessage("\e[K");
                UART_SendMessage("Output shaft speed set to 100% of maximum(180.0 RPM)\r\n");
-               g_MCP.fSP = 180.0f;
+               MOTOR_SetSetpoint(&g_MCP, 180.0f);
                UART_SendMessage("\e(B");  // ASCII
                UART_SendMessage("\e[0m"); // Normal Attributes
                break;
@@ -433,61 +661,61 @@ void  UART_ReadChar(uint8_t uiData, float *UART_SS0Read)
            case '0':
            {
                UART_SendMessage("Output shaft speed set to 0% of maximum(0.0 RPM)\r\n");
-               g_MCP.fSP = 0.0f;
+               MOTOR_SetSetpoint(&g_MCP, 0.0f);
                break;
            }
            case '1':
            {
                UART_SendMessage("Output shaft speed set to 10% of maximum(18.0 RPM)\r\n");
-               g_MCP.fSP = 18.0f;
+               MOTOR_SetSetpoint(&g_MCP, 18.0f);
                break;
            }
            case '2':
            {
                UART_SendMessage("Output shaft speed set to 20% of maximum(36.0 RPM)\r\n");
-               g_MCP.fSP = 36.0f;
+               MOTOR_SetSetpoint(&g_MCP, 36.0f);
                break;
            }
            case '3':
            {
                UART_SendMessage("Output shaft speed set to 30% of maximum(54.0 RPM)\r\n");
-               g_MCP.fSP = 54.0f;
+               MOTOR_SetSetpoint(&g_MCP, 54.0f);
                break;
            }
            case '4':
            {
                UART_SendMessage("Output shaft speed set to 40% of maximum(72.0 RPM)\r\n");
-               g_MCP.fSP = 72.0f;
+               MOTOR_SetSetpoint(&g_MCP, 72.0f);
                break;
            }
            case '5':
            {
                UART_SendMessage("Output shaft speed set to 50% of maximum(90.0 RPM)\r\n");
-               g_MCP.fSP = 90.0f;
+               MOTOR_SetSetpoint(&g_MCP, 90.0f);
                break;
            }
            case '6':
            {
                UART_SendMessage("Output shaft speed set to 60% of maximum(108.0 RPM)\r\n");
-               g_MCP.fSP = 108.0f;
+               MOTOR_SetSetpoint(&g_MCP, 108.0f);
                break;
            }
            case '7':
            {
                UART_SendMessage("Output shaft speed set to 70% of maximum(126.0 RPM)\r\n");
-               g_MCP.fSP = 126.0f;
+               MOTOR_SetSetpoint(&g_MCP, 126.0f);
                break;
            }
            case '8':
            {
                UART_SendMessage("Output shaft speed set to 80% of maximum(144.0 RPM)\r\n");
-               g_MCP.fSP = 144.0f;
+               MOTOR_SetSetpoint(&g_MCP, 144.0f);
                break;
            }
            case '9':
            {
                UART_SendMessage("Output shaft speed set to 90% of maximum(180.0 RPM)\r\n");
-               g_MCP.fSP = 162.0f;
+               MOTOR_SetSetpoint(&g_MCP, 162.0f);
                break;
            }
 